@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ConvexDecomposition.h"
+#include "GeometricPredicates.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	int32 FindEdge(const TArray<int32>& Part, int32 A, int32 B)
+	{
+		for (int32 i = 0; i < Part.Num(); ++i) {
+			if (Part[i] == A && Part[(i + 1) % Part.Num()] == B) {
+				return i;
+			}
+		}
+		return INDEX_NONE;
+	}
+}
+
+void ConvexDecomposition::Decompose(TArrayView<const FVector2D> Polygon, TArray<TArray<int32>>& OutParts)
+{
+	OutParts.Reset();
+
+	const int32 Num = Polygon.Num();
+	if (Num < 3) {
+		return;
+	}
+
+	double TwiceArea = 0.0;
+	TArray<int32> Order;
+	Order.Reserve(Num);
+	for (int32 i = 0; i < Num; ++i) {
+		TwiceArea += FVector2D::CrossProduct(Polygon[i], Polygon[(i + 1) % Num]);
+		Order.Add(i);
+	}
+	if (TwiceArea < 0.0) {
+		Algo::Reverse(Order);
+	}
+
+	if (IsConvex(Polygon)) {
+		OutParts.Add(MoveTemp(Order));
+		return;
+	}
+
+	TArray<TArray<int32>> Parts;
+	TArray<TPair<int32, int32>> Diagonals;
+	EarClip(Polygon, Order, Parts, Diagonals);
+
+	// Hertel-Mehlhorn: remove every diagonal whose two sides merge into a convex part
+	TArray<bool> Alive;
+	Alive.Init(true, Parts.Num());
+
+	for (const TPair<int32, int32>& Diagonal : Diagonals)
+	{
+		int32 First = INDEX_NONE;
+		int32 Second = INDEX_NONE;
+		for (int32 p = 0; p < Parts.Num(); ++p) {
+			if (!Alive[p]) {
+				continue;
+			}
+			if (FindEdge(Parts[p], Diagonal.Key, Diagonal.Value) != INDEX_NONE) {
+				First = p;
+			}
+			else if (FindEdge(Parts[p], Diagonal.Value, Diagonal.Key) != INDEX_NONE) {
+				Second = p;
+			}
+		}
+
+		if (First != INDEX_NONE && Second != INDEX_NONE && TryMerge(Polygon, Parts[First], Parts[Second], Diagonal.Key, Diagonal.Value)) {
+			Alive[Second] = false;
+		}
+	}
+
+	for (int32 p = 0; p < Parts.Num(); ++p) {
+		if (Alive[p]) {
+			OutParts.Add(MoveTemp(Parts[p]));
+		}
+	}
+}
+
+/* True when no two corners turn in opposite directions; collinear corners are allowed */
+bool ConvexDecomposition::IsConvex(TArrayView<const FVector2D> Polygon)
+{
+	const int32 Num = Polygon.Num();
+	bool bAnyLeft = false;
+	bool bAnyRight = false;
+
+	for (int32 i = 0; i < Num; ++i) {
+		double Turn = GeometricPredicates::Orient2D(Polygon[(i + Num - 1) % Num], Polygon[i], Polygon[(i + 1) % Num]);
+		bAnyLeft |= Turn > 0.0;
+		bAnyRight |= Turn < 0.0;
+	}
+	return !(bAnyLeft && bAnyRight);
+}
+
+/* Triangulates the counter-clockwise Order; each cut diagonal is recorded with the triangle holding it as Key -> Value */
+void ConvexDecomposition::EarClip(TArrayView<const FVector2D> Polygon, const TArray<int32>& Order, TArray<TArray<int32>>& OutTriangles, TArray<TPair<int32, int32>>& OutDiagonals)
+{
+	TArray<int32> Remaining = Order;
+
+	while (Remaining.Num() > 3)
+	{
+		const int32 Num = Remaining.Num();
+
+		int32 Ear = INDEX_NONE;
+		for (int32 i = 0; i < Num && Ear == INDEX_NONE; ++i) {
+			if (IsEar(Polygon, Remaining, i)) {
+				Ear = i;
+			}
+		}
+
+		// Only degenerate outlines have no strict ear; cut the most convex corner so the loop still terminates
+		if (Ear == INDEX_NONE) {
+			double BestTurn = -UE_BIG_NUMBER;
+			for (int32 i = 0; i < Num; ++i) {
+				double Turn = GeometricPredicates::Orient2D(Polygon[Remaining[(i + Num - 1) % Num]], Polygon[Remaining[i]], Polygon[Remaining[(i + 1) % Num]]);
+				if (Turn > BestTurn) {
+					BestTurn = Turn;
+					Ear = i;
+				}
+			}
+		}
+
+		const int32 Prev = Remaining[(Ear + Num - 1) % Num];
+		const int32 Curr = Remaining[Ear];
+		const int32 Next = Remaining[(Ear + 1) % Num];
+
+		OutTriangles.Add({ Prev, Curr, Next });
+		OutDiagonals.Emplace(Next, Prev);
+		Remaining.RemoveAt(Ear, 1, false);
+	}
+
+	OutTriangles.Add(MoveTemp(Remaining));
+}
+
+bool ConvexDecomposition::IsEar(TArrayView<const FVector2D> Polygon, const TArray<int32>& Remaining, int32 Index)
+{
+	const int32 Num = Remaining.Num();
+	const FVector2D& A = Polygon[Remaining[(Index + Num - 1) % Num]];
+	const FVector2D& B = Polygon[Remaining[Index]];
+	const FVector2D& C = Polygon[Remaining[(Index + 1) % Num]];
+
+	if (GeometricPredicates::Orient2D(A, B, C) <= 0.0) {
+		return false;
+	}
+
+	// No other vertex may lie inside the triangle or on the diagonal being cut
+	for (int32 i = 0; i < Num; ++i) {
+		const FVector2D& P = Polygon[Remaining[i]];
+		if (P == A || P == B || P == C) {
+			continue;
+		}
+		if (GeometricPredicates::Orient2D(A, B, P) >= 0.0 && GeometricPredicates::Orient2D(B, C, P) >= 0.0 && GeometricPredicates::Orient2D(C, A, P) >= 0.0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Merges Second into First across the shared edge A -> B of First if both corners stay convex */
+bool ConvexDecomposition::TryMerge(TArrayView<const FVector2D> Polygon, TArray<int32>& First, const TArray<int32>& Second, int32 A, int32 B)
+{
+	const int32 N1 = First.Num();
+	const int32 N2 = Second.Num();
+	const int32 I1 = FindEdge(First, A, B);
+	const int32 I2 = FindEdge(Second, B, A);
+
+	const int32 BeforeA = First[(I1 + N1 - 1) % N1];
+	const int32 AfterA = Second[(I2 + 2) % N2];
+	const int32 BeforeB = Second[(I2 + N2 - 1) % N2];
+	const int32 AfterB = First[(I1 + 2) % N1];
+
+	if (GeometricPredicates::Orient2D(Polygon[BeforeA], Polygon[A], Polygon[AfterA]) < 0.0
+		|| GeometricPredicates::Orient2D(Polygon[BeforeB], Polygon[B], Polygon[AfterB]) < 0.0) {
+		return false;
+	}
+
+	// B .. A along First, then the rest of Second
+	TArray<int32> Merged;
+	Merged.Reserve(N1 + N2 - 2);
+	for (int32 k = 1; k <= N1; ++k) {
+		Merged.Add(First[(I1 + k) % N1]);
+	}
+	for (int32 k = 2; k < N2; ++k) {
+		Merged.Add(Second[(I2 + k) % N2]);
+	}
+	First = MoveTemp(Merged);
+	return true;
+}
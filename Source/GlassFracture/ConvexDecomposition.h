@@ -0,0 +1,23 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * ConvexDecomposition splits a simple polygon into convex parts with Hertel-Mehlhorn over an ear-clipped triangulation.
+ * The result has at most four times the minimum number of parts; convex input is returned whole.
+ */
+class GLASSFRACTURE_API ConvexDecomposition
+{
+public:
+	/* Each part is a list of indices into Polygon, counter-clockwise regardless of the input winding */
+	static void Decompose(TArrayView<const FVector2D> Polygon, TArray<TArray<int32>>& OutParts);
+
+	static bool IsConvex(TArrayView<const FVector2D> Polygon);
+
+private:
+	static void EarClip(TArrayView<const FVector2D> Polygon, const TArray<int32>& Order, TArray<TArray<int32>>& OutTriangles, TArray<TPair<int32, int32>>& OutDiagonals);
+	static bool IsEar(TArrayView<const FVector2D> Polygon, const TArray<int32>& Remaining, int32 Index);
+	static bool TryMerge(TArrayView<const FVector2D> Polygon, TArray<int32>& First, const TArray<int32>& Second, int32 A, int32 B);
+};
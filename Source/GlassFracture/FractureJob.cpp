@@ -0,0 +1,454 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FractureJob.h"
+#include "GlassFracture.h"
+#include "GlassMemoryUsage.h"
+#include "PolygonClipper.h"
+#include "PieceGrid.h"
+#include "SlabMeshBuilder.h"
+#include "GeometricPredicates.h"
+#include "PatternCells/FracturePatternGenerator.h"
+#include "PatternCells/FracturePatternAsset.h"
+#include "VoronoiDiagram/VoronoiGenerator.h"
+#include "Async/ParallelFor.h"
+
+namespace
+{
+	/* Output of one contiguous range of intact pieces, merged in range order */
+	struct ChunkOutput
+	{
+		TArray<Piece> ClippedPieces;
+		TArray<int32> ClippedParts;
+		TArray<Piece> OutsidePieces;
+	};
+
+	constexpr int32 MinSubjectsPerChunk = 4;
+
+	// Hull corners cutting off less than this fraction of the piece's bounds area are dropped
+	constexpr double FlatCornerTolerance = 1e-3;
+}
+
+SIZE_T FractureJobResult::GetAllocatedSize() const
+{
+	GlassMemoryUsage Usage;
+	Usage.AddPieces(PatternCells);
+	Usage.AddPieces(ClippedPieces);
+	Usage.AddPieces(OutsidePieces);
+	Usage.AddPieces(CoarsePieces);
+	SIZE_T Bytes = Usage.Total();
+
+	Bytes += CellToPiecesMap.GetAllocatedSize();
+	for (const TPair<int32, TArray<int32>>& Pair : CellToPiecesMap) {
+		Bytes += Pair.Value.GetAllocatedSize();
+	}
+	for (const TArray<TArray<FVector>>* Hulls : { &ClippedHulls, &OutsideHulls }) {
+		Bytes += Hulls->GetAllocatedSize();
+		for (const TArray<FVector>& Hull : *Hulls) {
+			Bytes += Hull.GetAllocatedSize();
+		}
+	}
+
+	auto MeshBytes = [](const PieceMeshData& Mesh) {
+		return Mesh.Vertices.GetAllocatedSize() + Mesh.Triangles.GetAllocatedSize() + Mesh.Normals.GetAllocatedSize()
+			+ Mesh.UVs.GetAllocatedSize() + Mesh.Tangents.GetAllocatedSize();
+	};
+	Bytes += DirtySections.GetAllocatedSize() + SectionMeshes.GetAllocatedSize() + CellSections.GetAllocatedSize();
+	for (const PieceMeshData& Mesh : SectionMeshes) {
+		Bytes += MeshBytes(Mesh);
+	}
+	for (const TPair<int32, PieceMeshData>& Pair : CellSections) {
+		Bytes += MeshBytes(Pair.Value);
+	}
+	return Bytes;
+}
+
+FractureJobResult FractureJob::Run(const FractureJobInput& Input)
+{
+	GLASSFRACTURE_SCOPE(Job);
+	CSV_SCOPED_TIMING_STAT(GlassFracture, FractureJob);
+	LLM_SCOPE_BYTAG(GlassFracture);
+	const double StartTime = FPlatformTime::Seconds();
+
+	FractureJobResult Result;
+
+	{
+		GLASSFRACTURE_SCOPE(Pattern);
+		//Result.PatternCells = FracturePatternGenerator::CreateDiagonalPieces(WorldHitLocation, LocalMaxBound - LocalMinBound, GetActorLocation());
+		Result.PatternCells = FracturePatternGenerator::CreateSpiderwebPieces(Input.PatternLocation, Input.Pattern);
+	}
+
+	// Lazy panes: split the coarse remainder around the impact into Voronoi cells before clipping
+	TArray<Piece> RefinedPieces;
+	const TArray<Piece>* Subjects = &Input.IntactPieces;
+	if (Input.RefineSites.Num() > 0) {
+		RefinedPieces = Input.IntactPieces;
+		RefineCoarsePieces(Input, RefinedPieces, Result.CoarsePieces);
+		Subjects = &RefinedPieces;
+	}
+	else {
+		Result.CoarsePieces = Input.CoarsePieces;
+	}
+
+	const TArray<Piece>& PatternCells = Result.PatternCells;
+	const TArray<Piece>& IntactPieces = *Subjects;
+	TArray<Piece>& ClippedPieces = Result.ClippedPieces;
+	TArray<Piece>& OutsidePieces = Result.OutsidePieces;
+	TMap<int32, TArray<int32>>& CellToPiecesMap = Result.CellToPiecesMap;
+
+	const float ImpactRadius = Input.ImpactRadius;
+	const Point Center(Input.ImpactCenter.X, Input.ImpactCenter.Y);
+	FBox2D ImpactBounds(FVector2D(Center.x - ImpactRadius, Center.z - ImpactRadius), FVector2D(Center.x + ImpactRadius, Center.z + ImpactRadius));
+
+	// Broad phase: only clip against pattern cells whose bounds overlap the subject
+	PieceGrid PatternGrid;
+	{
+		GLASSFRACTURE_SCOPE(BroadPhase);
+		PatternGrid.Build(PatternCells);
+	}
+
+	// Each worker clips a contiguous range of subjects into its own buffers
+	const int32 MaxChunks = (FTaskGraphInterface::Get().GetNumWorkerThreads() + 1) * 4;
+	const int32 NumChunks = FMath::Clamp(IntactPieces.Num() / MinSubjectsPerChunk, 1, MaxChunks);
+	TArray<ChunkOutput> Chunks;
+	Chunks.SetNum(NumChunks);
+
+	ParallelFor(NumChunks, [&](int32 ChunkIndex)
+	{
+		LLM_SCOPE_BYTAG(GlassFracture);
+		ChunkOutput& Chunk = Chunks[ChunkIndex];
+		TArray<int32> CandidateCells;
+		// Reused for every subject in the chunk, so clipping only allocates while these buffers grow
+		PolygonClipper::ClipBatch ClipResults;
+		int32 ClipCalls = 0;
+
+		const int32 First = (int64)IntactPieces.Num() * ChunkIndex / NumChunks;
+		const int32 Last = (int64)IntactPieces.Num() * (ChunkIndex + 1) / NumChunks;
+
+		for (int32 i = First; i < Last; ++i) {
+			const Piece& Subject = IntactPieces[i];
+
+			if (!Subject.bounds.Intersect(ImpactBounds)) {
+				Chunk.OutsidePieces.Add(Subject);
+				continue;
+			}
+
+			ECircleIntersectionType IntersectionResult;
+			{
+				GLASSFRACTURE_SCOPE(Classify);
+				IntersectionResult = CheckPieceCircleIntersection(Subject, FVector(Center.x, 0.0f, Center.z), ImpactRadius);
+			}
+
+			if (IntersectionResult == ECircleIntersectionType::Outside) {
+				Chunk.OutsidePieces.Add(Subject);
+				continue;
+			}
+
+			{
+				GLASSFRACTURE_SCOPE(BroadPhase);
+				PatternGrid.Query(Subject.bounds, CandidateCells);
+			}
+			{
+				GLASSFRACTURE_SCOPE(Clip);
+				PolygonClipper::ClipAgainstCells(Subject.points, PatternCells, CandidateCells, ClipResults);
+			}
+			ClipCalls += CandidateCells.Num();
+
+			GLASSFRACTURE_SCOPE(Classify);
+			for (int32 k = 0; k < ClipResults.Num(); ++k) {
+				Piece NewPiece(ClipResults.GetPolygon(k));
+				ECircleIntersectionType ClippedIntersectionResult = CheckPieceCircleIntersection(NewPiece, FVector(Center.x, 0.0f, Center.z), ImpactRadius);
+
+				switch (ClippedIntersectionResult) {
+				case ECircleIntersectionType::Inside:
+				case ECircleIntersectionType::Overlapping:
+					Chunk.ClippedPieces.Add(MoveTemp(NewPiece));
+					Chunk.ClippedParts.Add(ClipResults.CellIndices[k]);
+					break;
+				case ECircleIntersectionType::Outside:
+					Chunk.OutsidePieces.Add(MoveTemp(NewPiece));
+					break;
+				}
+			}
+		}
+
+		INC_DWORD_STAT_BY(STAT_GlassFracture_ClipCalls, ClipCalls);
+	});
+
+	// Merge in subject order so piece order and PieceIndex never depend on scheduling
+	// Pieces are grouped by the pattern cell their convex part was cut from
+	int32 PieceIndex = 0;
+	for (ChunkOutput& Chunk : Chunks) {
+		for (int32 k = 0; k < Chunk.ClippedPieces.Num(); ++k) {
+			const int32 j = Input.Pattern->PartCells[Chunk.ClippedParts[k]];
+			ClippedPieces.Add(MoveTemp(Chunk.ClippedPieces[k]));
+			UE_LOG(LogGlassFracture, Verbose, TEXT("Piece %d generated clipped piece %d"), j, PieceIndex);
+
+			CellToPiecesMap.FindOrAdd(j).Add(PieceIndex);
+			PieceIndex++;
+		}
+		OutsidePieces.Append(MoveTemp(Chunk.OutsidePieces));
+	}
+
+	// Shards are spawned in map order, which has to match on every machine replaying the same hit
+	CellToPiecesMap.KeySort(TLess<int32>());
+	INC_DWORD_STAT_BY(STAT_GlassFracture_PiecesIn, IntactPieces.Num());
+	INC_DWORD_STAT_BY(STAT_GlassFracture_PiecesOut, ClippedPieces.Num() + OutsidePieces.Num());
+
+	// Pieces left in the pane: outside pieces followed by coarse pieces
+	const int32 NumOutside = OutsidePieces.Num();
+	TArray<const Piece*> AfterPieces;
+	AfterPieces.Reserve(NumOutside + Result.CoarsePieces.Num());
+	for (const TArray<Piece>* Pieces : { &OutsidePieces, &Result.CoarsePieces }) {
+		for (const Piece& After : *Pieces) {
+			AfterPieces.Add(&After);
+		}
+	}
+	TArray<const Piece*> FallingPieces;
+	FallingPieces.Reserve(ClippedPieces.Num());
+	for (const Piece& Falling : ClippedPieces) {
+		FallingPieces.Add(&Falling);
+	}
+
+	Result.ClippedHulls.SetNum(FallingPieces.Num());
+	ParallelFor(FallingPieces.Num(), [&](int32 i)
+	{
+		LLM_SCOPE_BYTAG(GlassFracture);
+		GLASSFRACTURE_SCOPE(Hulls);
+		BuildCollisionHull(*FallingPieces[i], Input.Hulls, Result.ClippedHulls[i]);
+	});
+	Result.OutsideHulls.SetNum(AfterPieces.Num());
+	ParallelFor(AfterPieces.Num(), [&](int32 i)
+	{
+		LLM_SCOPE_BYTAG(GlassFracture);
+		GLASSFRACTURE_SCOPE(Hulls);
+		BuildCollisionHull(*AfterPieces[i], Input.Hulls, Result.OutsideHulls[i]);
+	});
+
+	// Compare an order-independent hash of each section's pieces before and after the hit
+	const int32 NumSections = FMath::Square(FMath::Max(Input.SectionTiles, 1));
+	TArray<uint32> HashBefore;
+	TArray<uint32> HashAfter;
+	TArray<TArray<int32>> SectionPieces;
+	HashBefore.Init(0, NumSections);
+	HashAfter.Init(0, NumSections);
+	SectionPieces.SetNum(NumSections);
+
+	for (const TArray<Piece>* Pieces : { &Input.IntactPieces, &Input.CoarsePieces }) {
+		for (const Piece& Before : *Pieces) {
+			HashBefore[SectionOf(Before, Input)] += HashPiece(Before);
+		}
+	}
+	for (int32 i = 0; i < AfterPieces.Num(); ++i) {
+		const int32 Section = SectionOf(*AfterPieces[i], Input);
+		HashAfter[Section] += HashPiece(*AfterPieces[i]);
+		SectionPieces[Section].Add(i);
+	}
+
+	for (int32 Section = 0; Section < NumSections; ++Section) {
+		if (Input.bRebuildAllSections || HashBefore[Section] != HashAfter[Section]) {
+			Result.DirtySections.Add(Section);
+		}
+	}
+
+	// Every section is written straight into its final buffers, one allocation per buffer
+	SlabSettings Slab;
+	Slab.Thickness = Input.Hulls.Thickness;
+	if (Input.PaneBounds.bIsValid) {
+		Slab.UVBounds = Input.PaneBounds;
+	}
+
+	Result.SectionMeshes.SetNum(Result.DirtySections.Num());
+	INC_DWORD_STAT_BY(STAT_GlassFracture_SectionsRebuilt, Result.DirtySections.Num());
+	ParallelFor(Result.DirtySections.Num(), [&](int32 k)
+	{
+		LLM_SCOPE_BYTAG(GlassFracture);
+		GLASSFRACTURE_SCOPE(Triangulate);
+		SlabMeshBuilder::BuildSection(AfterPieces, SectionPieces[Result.DirtySections[k]], Slab, Result.SectionMeshes[k]);
+	});
+
+	// One section per falling cell
+	TArray<int32> Cells;
+	CellToPiecesMap.GetKeys(Cells);
+	for (int32 Cell : Cells) {
+		Result.CellSections.Add(Cell);
+	}
+	ParallelFor(Cells.Num(), [&](int32 k)
+	{
+		LLM_SCOPE_BYTAG(GlassFracture);
+		GLASSFRACTURE_SCOPE(Triangulate);
+		SlabMeshBuilder::BuildSection(FallingPieces, CellToPiecesMap.FindChecked(Cells[k]), Slab, Result.CellSections.FindChecked(Cells[k]));
+	});
+
+	Result.ComputeSeconds = FPlatformTime::Seconds() - StartTime;
+	return Result;
+}
+
+/* Coarse pieces overlapping the region are replaced by the region's cells inside them, plus up to four remainder boxes */
+void FractureJob::RefineCoarsePieces(const FractureJobInput& Input, TArray<Piece>& IntactPieces, TArray<Piece>& CoarsePieces)
+{
+	GLASSFRACTURE_SCOPE(Refine);
+	const FBox2D& Region = Input.RefineRegion;
+	const TArray<Piece> RegionCells = VoronoiGenerator::GenerateVoronoiCells(Input.RefineSites,
+		FVector(Region.Min.X, 0.0f, Region.Min.Y), FVector(Region.Max.X, 0.0f, Region.Max.Y), Input.Backend);
+
+	PolygonClipper::ClipScratch Scratch;
+
+	for (const Piece& Coarse : Input.CoarsePieces) {
+		const FBox2D& Box = Coarse.bounds;
+		if (!Box.Intersect(Region)) {
+			CoarsePieces.Add(Coarse);
+			continue;
+		}
+
+		FBox2D Overlap(FVector2D(FMath::Max(Box.Min.X, Region.Min.X), FMath::Max(Box.Min.Y, Region.Min.Y)),
+					   FVector2D(FMath::Min(Box.Max.X, Region.Max.X), FMath::Min(Box.Max.Y, Region.Max.Y)));
+
+		// Clip polygons are wound clockwise
+		const Point OverlapPolygon[] = {
+			Point(Overlap.Min.X, Overlap.Min.Y),
+			Point(Overlap.Min.X, Overlap.Max.Y),
+			Point(Overlap.Max.X, Overlap.Max.Y),
+			Point(Overlap.Max.X, Overlap.Min.Y)
+		};
+
+		for (const Piece& Cell : RegionCells) {
+			if (!Cell.bounds.Intersect(Overlap)) {
+				continue;
+			}
+			TArrayView<const Point> Clipped = PolygonClipper::ClipConvex(Cell.points, MakeArrayView(OverlapPolygon), Scratch);
+			if (Clipped.Num() > 2) {
+				IntactPieces.Add(Piece(TArray<Point>(Clipped)));
+			}
+		}
+
+		// Bands below and above the region, then the left and right parts beside it
+		if (Box.Min.Y < Overlap.Min.Y) {
+			CoarsePieces.Add(MakeBoxPiece(FBox2D(Box.Min, FVector2D(Box.Max.X, Overlap.Min.Y))));
+		}
+		if (Overlap.Max.Y < Box.Max.Y) {
+			CoarsePieces.Add(MakeBoxPiece(FBox2D(FVector2D(Box.Min.X, Overlap.Max.Y), Box.Max)));
+		}
+		if (Box.Min.X < Overlap.Min.X) {
+			CoarsePieces.Add(MakeBoxPiece(FBox2D(FVector2D(Box.Min.X, Overlap.Min.Y), FVector2D(Overlap.Min.X, Overlap.Max.Y))));
+		}
+		if (Overlap.Max.X < Box.Max.X) {
+			CoarsePieces.Add(MakeBoxPiece(FBox2D(FVector2D(Overlap.Max.X, Overlap.Min.Y), FVector2D(Box.Max.X, Overlap.Max.Y))));
+		}
+	}
+}
+
+Piece FractureJob::MakeBoxPiece(const FBox2D& Box)
+{
+	return Piece(TArray<Point>{
+		Point(Box.Min.X, Box.Min.Y),	// Bottom-Left
+		Point(Box.Max.X, Box.Min.Y),	// Bottom-Right
+		Point(Box.Max.X, Box.Max.Y),	// Top-Right
+		Point(Box.Min.X, Box.Max.Y)		// Top-Left
+	});
+}
+
+FractureJob::ECircleIntersectionType
+FractureJob::CheckPieceCircleIntersection(const Piece& Piece, const FVector& CircleCenter, float Radius)
+{
+	bool bAllInside = true;
+	bool bAnyInside = false;
+
+	const FVector2D Center(CircleCenter.X, CircleCenter.Z);
+
+	for (const Point& point : Piece.points)
+	{
+		if (GeometricPredicates::InDisk(FVector2D(point.x, point.z), Center, Radius) >= 0.0)
+		{
+			bAnyInside = true;
+		}
+		else
+		{
+			bAllInside = false;
+		}
+	}
+
+	if (bAllInside) 
+	{
+		return ECircleIntersectionType::Inside;
+	}
+	if (bAnyInside)
+	{
+		return ECircleIntersectionType::Overlapping;
+	}
+	return ECircleIntersectionType::Outside;
+}
+
+/* Prism of the piece's outline; flat and surplus corners are collapsed first, tiny pieces collide as their bounding box */
+void FractureJob::BuildCollisionHull(const Piece& Piece, const CollisionHullSettings& Settings, TArray<FVector>& OutHull)
+{
+	TArray<FVector2D, TInlineAllocator<32>> Outline;
+	const FBox2D& Bounds = Piece.bounds;
+
+	if (Settings.ProxySize > 0.0f && Bounds.GetSize().GetMax() <= Settings.ProxySize)
+	{
+		Outline.Add(Bounds.Min);
+		Outline.Add(FVector2D(Bounds.Max.X, Bounds.Min.Y));
+		Outline.Add(Bounds.Max);
+		Outline.Add(FVector2D(Bounds.Min.X, Bounds.Max.Y));
+	}
+	else
+	{
+		for (const Point& point : Piece.points) {
+			Outline.Add(FVector2D(point.x, point.z));
+		}
+
+		// Removing a corner of a convex outline cuts off the triangle it spans with its neighbors; always take the cheapest one
+		const int32 MaxCorners = FMath::Max(Settings.MaxVertices / 2, 3);
+		const double Tolerance = FlatCornerTolerance * Bounds.GetArea();
+		while (Outline.Num() > 3)
+		{
+			const int32 Num = Outline.Num();
+			int32 Cheapest = INDEX_NONE;
+			double CheapestLoss = UE_BIG_NUMBER;
+			for (int32 i = 0; i < Num; ++i) {
+				const FVector2D& Prev = Outline[(i + Num - 1) % Num];
+				const FVector2D& Next = Outline[(i + 1) % Num];
+				double Loss = 0.5 * FMath::Abs(FVector2D::CrossProduct(Outline[i] - Prev, Next - Outline[i]));
+				if (Loss < CheapestLoss) {
+					CheapestLoss = Loss;
+					Cheapest = i;
+				}
+			}
+			if (Num <= MaxCorners && CheapestLoss > Tolerance) {
+				break;
+			}
+			Outline.RemoveAt(Cheapest, 1, false);
+		}
+	}
+
+	const float HalfThickness = 0.5f * Settings.Thickness;
+	OutHull.Reset(2 * Outline.Num());
+	for (const FVector2D& Corner : Outline) {
+		OutHull.Add(FVector(Corner.X, -HalfThickness, Corner.Y));
+		OutHull.Add(FVector(Corner.X, HalfThickness, Corner.Y));
+	}
+}
+
+int32 FractureJob::SectionOf(const Piece& Piece, const FractureJobInput& Input)
+{
+	const int32 Tiles = FMath::Max(Input.SectionTiles, 1);
+	const FVector2D Size = Input.PaneBounds.GetSize();
+	if (Tiles == 1 || Size.X <= 0.0 || Size.Y <= 0.0) {
+		return 0;
+	}
+
+	const FVector2D Center = Piece.bounds.GetCenter();
+	const int32 X = FMath::Clamp(FMath::FloorToInt32((Center.X - Input.PaneBounds.Min.X) / Size.X * Tiles), 0, Tiles - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt32((Center.Y - Input.PaneBounds.Min.Y) / Size.Y * Tiles), 0, Tiles - 1);
+	return Z * Tiles + X;
+}
+
+uint32 FractureJob::HashPiece(const Piece& Piece)
+{
+	uint32 Hash = GetTypeHash(Piece.points.Num());
+	for (const Point& point : Piece.points) {
+		Hash = HashCombine(Hash, GetTypeHash(point));
+	}
+	return Hash;
+}
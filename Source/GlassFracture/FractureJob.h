@@ -0,0 +1,94 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TriangulationTypes.h"
+#include "SlabMeshBuilder.h"
+#include "VoronoiDiagram/VoronoiBackend.h"
+
+class UFracturePatternAsset;
+
+/* How pieces are turned into collision hulls */
+struct CollisionHullSettings
+{
+	float Thickness = 1.0f;		// Prism depth along Y, centered on the pane plane; render slabs use it too
+	int32 MaxVertices = 16;		// Per hull, both faces counted
+	float ProxySize = 0.0f;		// Pieces whose bounds fit in this size collide as a box, 0 disables
+};
+
+/* Inputs of one fracture, captured on the game thread when the hit arrives */
+struct FractureJobInput
+{
+	TArray<Piece> IntactPieces;
+	FVector PatternLocation = FVector::ZeroVector;
+	FVector2D ImpactCenter = FVector2D::ZeroVector;
+	float ImpactRadius = 0.0f;
+
+	// Axis-aligned remainders not yet split into Voronoi cells; those overlapping RefineRegion are refined from RefineSites first
+	TArray<Piece> CoarsePieces;
+	TArray<Point> RefineSites;
+	FBox2D RefineRegion = FBox2D(ForceInit);
+	EVoronoiBackend Backend = EVoronoiBackend::Delaunay;
+
+	// Intact geometry is rendered as SectionTiles x SectionTiles sections over PaneBounds, keyed by piece center
+	FBox2D PaneBounds = FBox2D(ForceInit);
+	int32 SectionTiles = 1;
+	bool bRebuildAllSections = true;
+
+	CollisionHullSettings Hulls;
+
+	// Read-only at runtime, kept alive by the owning actor until the job finishes
+	const UFracturePatternAsset* Pattern = nullptr;
+};
+
+struct FractureJobResult
+{
+	TArray<Piece> PatternCells;		// Convex parts of the pattern cells, see UFracturePatternAsset::PartCells
+	TArray<Piece> ClippedPieces;
+	TArray<Piece> OutsidePieces;
+	TArray<Piece> CoarsePieces;
+	TMap<int32, TArray<int32>> CellToPiecesMap;	// Sorted by cell
+
+	// One thick convex hull per piece
+	TArray<TArray<FVector>> ClippedHulls;	// Parallel to ClippedPieces
+	TArray<TArray<FVector>> OutsideHulls;	// Parallel to OutsidePieces followed by CoarsePieces
+
+	// Render geometry packed per section
+	TArray<int32> DirtySections;				// Intact sections whose pieces changed, everything else is left as is
+	TArray<PieceMeshData> SectionMeshes;		// Parallel to DirtySections, empty when the section lost all its pieces
+	TMap<int32, PieceMeshData> CellSections;	// Keyed like CellToPiecesMap
+
+	double ComputeSeconds = 0.0;
+
+	/* Heap bytes held by the arrays above */
+	SIZE_T GetAllocatedSize() const;
+};
+
+/**
+ * FractureJob holds the pure-geometry stages of a hit: pattern generation, clipping, circle classification and triangulation.
+ * It touches no components or world state, so it can run on a worker thread.
+ */
+class GLASSFRACTURE_API FractureJob
+{
+public:
+	enum class ECircleIntersectionType
+	{
+		Inside,      // Fully contained within the circle
+		Overlapping, // Partially overlapping with the circle
+		Outside      // Completely outside the circle
+	};
+
+	static FractureJobResult Run(const FractureJobInput& Input);
+
+	static ECircleIntersectionType CheckPieceCircleIntersection(const Piece& Piece, const FVector& CircleCenter, float Radius);
+	static void BuildCollisionHull(const Piece& Piece, const CollisionHullSettings& Settings, TArray<FVector>& OutHull);
+
+	/* Counter-clockwise rectangle, the winding of Voronoi cells */
+	static Piece MakeBoxPiece(const FBox2D& Box);
+
+private:
+	static int32 SectionOf(const Piece& Piece, const FractureJobInput& Input);
+	static uint32 HashPiece(const Piece& Piece);
+	static void RefineCoarsePieces(const FractureJobInput& Input, TArray<Piece>& IntactPieces, TArray<Piece>& CoarsePieces);
+};
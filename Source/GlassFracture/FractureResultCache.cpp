@@ -0,0 +1,187 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FractureResultCache.h"
+#include "GlassFracture.h"
+#include "PatternCells/FracturePatternAsset.h"
+#include "VoronoiDiagram/PaneLayoutAsset.h"
+#include "Engine/DataTable.h"
+#include "Engine/World.h"
+
+static TAutoConsoleVariable<int32> CVarFractureCacheMaxEntries(
+	TEXT("glass.FractureCache.MaxEntries"), 256,
+	TEXT("Fracture results kept for repeat hits, 0 disables the cache."));
+
+static TAutoConsoleVariable<int32> CVarFractureCacheMaxMB(
+	TEXT("glass.FractureCache.MaxMB"), 64,
+	TEXT("Memory the cached fracture results may hold, in MB."));
+
+static TAutoConsoleVariable<float> CVarFractureCacheGrid(
+	TEXT("glass.FractureCache.Grid"), 0.0f,
+	TEXT("Grid the server snaps pane-local impacts to so nearby hits reuse cached results, 0 keeps impacts exact."));
+
+static FAutoConsoleCommand CmdFractureCacheReport(
+	TEXT("glass.FractureCache.Report"),
+	TEXT("Logs the fracture result cache size, memory, hit rate and evictions."),
+	FConsoleCommandDelegate::CreateStatic([]()
+	{
+		FractureResultCache::Get().ReportStats();
+	}));
+
+static FAutoConsoleCommand CmdFractureCacheReset(
+	TEXT("glass.FractureCache.Reset"),
+	TEXT("Drops every cached fracture result."),
+	FConsoleCommandDelegate::CreateStatic([]()
+	{
+		FractureResultCache::Get().Reset();
+	}));
+
+FractureResultCache& FractureResultCache::Get()
+{
+	static FractureResultCache Cache;
+	check(IsInGameThread());
+	return Cache;
+}
+
+/* Never unregistered: the cache lives until exit */
+FractureResultCache::FractureResultCache()
+{
+	FWorldDelegates::OnWorldCleanup.AddRaw(this, &FractureResultCache::OnWorldCleanup);
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &FractureResultCache::OnObjectModified);
+	FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda([this](UObject* Object, FPropertyChangedEvent&) { OnObjectModified(Object); });
+#endif
+}
+
+/* Ending a PIE session or loading another map drops every result */
+void FractureResultCache::OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	if (Entries.Num() > 0)
+	{
+		Reset();
+	}
+}
+
+#if WITH_EDITOR
+/* Content-hashed keys already miss after an edit; this frees the results that can no longer be hit */
+void FractureResultCache::OnObjectModified(UObject* Object)
+{
+	if (Entries.Num() > 0 && (Cast<UFracturePatternAsset>(Object) || Cast<UPaneLayoutAsset>(Object) || Cast<UDataTable>(Object)))
+	{
+		Reset();
+	}
+}
+#endif
+
+float FractureResultCache::GetImpactGrid()
+{
+	return FMath::Max(CVarFractureCacheGrid.GetValueOnGameThread(), 0.0f);
+}
+
+bool FractureResultCache::IsEnabled()
+{
+	return CVarFractureCacheMaxEntries.GetValueOnGameThread() > 0;
+}
+
+TSharedPtr<const FractureJobResult> FractureResultCache::Find(const Key& InKey)
+{
+	Entry* Found = Entries.Find(InKey);
+	if (!Found)
+	{
+		Misses++;
+		PublishStats();
+		return nullptr;
+	}
+
+	Hits++;
+	Found->LastUsed = ++UseClock;
+	PublishStats();
+	return Found->Result;
+}
+
+TSharedPtr<const FractureJobResult> FractureResultCache::Add(const Key& InKey, FractureJobResult&& Result)
+{
+	LLM_SCOPE_BYTAG(GlassFracture);
+
+	const SIZE_T MaxBytes = (SIZE_T)FMath::Max(CVarFractureCacheMaxMB.GetValueOnGameThread(), 0) * 1024 * 1024;
+	const SIZE_T Bytes = sizeof(FractureJobResult) + Result.GetAllocatedSize();
+	TSharedPtr<const FractureJobResult> Shared = MakeShared<const FractureJobResult>(MoveTemp(Result));
+	if (!IsEnabled() || Bytes > MaxBytes)
+	{
+		return Shared;
+	}
+
+	if (Entry* Existing = Entries.Find(InKey))
+	{
+		TotalBytes -= Existing->Bytes;
+		Entries.Remove(InKey);
+	}
+	Evict(CVarFractureCacheMaxEntries.GetValueOnGameThread() - 1, MaxBytes - Bytes);
+
+	Entry& Added = Entries.Add(InKey);
+	Added.Result = Shared;
+	Added.Bytes = Bytes;
+	Added.LastUsed = ++UseClock;
+	TotalBytes += Bytes;
+
+	PublishStats();
+	return Shared;
+}
+
+void FractureResultCache::Reset()
+{
+	Entries.Empty();
+	TotalBytes = 0;
+	PublishStats();
+}
+
+void FractureResultCache::Evict(int32 MaxEntries, SIZE_T MaxBytes)
+{
+	while (Entries.Num() > 0 && (Entries.Num() > MaxEntries || TotalBytes > MaxBytes))
+	{
+		const Key* Oldest = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<Key, Entry>& Pair : Entries)
+		{
+			if (Pair.Value.LastUsed < OldestUse)
+			{
+				OldestUse = Pair.Value.LastUsed;
+				Oldest = &Pair.Key;
+			}
+		}
+
+		// Panes still applying the result hold their own reference
+		const Key Evicted = *Oldest;
+		TotalBytes -= Entries.FindChecked(Evicted).Bytes;
+		Entries.Remove(Evicted);
+		Evictions++;
+	}
+}
+
+FractureResultCache::CacheStats FractureResultCache::GetStats() const
+{
+	CacheStats Stats;
+	Stats.Entries = Entries.Num();
+	Stats.Bytes = TotalBytes;
+	Stats.Hits = Hits;
+	Stats.Misses = Misses;
+	Stats.Evictions = Evictions;
+	return Stats;
+}
+
+void FractureResultCache::ReportStats() const
+{
+	const CacheStats Stats = GetStats();
+	const int32 Lookups = Stats.Hits + Stats.Misses;
+	UE_LOG(LogGlassFracture, Log, TEXT("Fracture result cache: %d results, %.1f KB, %d hits / %d lookups (%.1f%%), %d evicted"),
+		Stats.Entries, Stats.Bytes / 1024.0, Stats.Hits, Lookups, Lookups > 0 ? 100.0 * Stats.Hits / Lookups : 0.0, Stats.Evictions);
+}
+
+void FractureResultCache::PublishStats() const
+{
+	SET_DWORD_STAT(STAT_GlassFracture_CachedResults, Entries.Num());
+	SET_MEMORY_STAT(STAT_GlassFracture_CacheMemory, TotalBytes);
+	SET_DWORD_STAT(STAT_GlassFracture_CacheHits, Hits);
+	SET_DWORD_STAT(STAT_GlassFracture_CacheMisses, Misses);
+	SET_DWORD_STAT(STAT_GlassFracture_CacheEvictions, Evictions);
+}
@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FractureJob.h"
+
+/**
+ * FractureResultCache keeps finished fracture results, least recently used first out, for every pane in the process.
+ * Results are in pane space, so panes of one type share entries wherever they are placed; applying one costs a copy.
+ * Cooked shard collision is not stored here, UGlassShardSubsystem already shares it by shape.
+ * Keys hash asset content rather than names; the cache is still emptied when a world is cleaned up or a pattern, layout or table is edited.
+ */
+class GLASSFRACTURE_API FractureResultCache
+{
+public:
+	struct Key
+	{
+		uint64 PaneState = 0;		// Layout and settings of the pane plus every hit applied so far
+		FVector2D ImpactCenter = FVector2D::ZeroVector;
+		bool bRebuildAllSections = false;
+
+		bool operator==(const Key& Other) const
+		{
+			return PaneState == Other.PaneState && ImpactCenter == Other.ImpactCenter && bRebuildAllSections == Other.bRebuildAllSections;
+		}
+		friend uint32 GetTypeHash(const Key& K)
+		{
+			return HashCombine(HashCombine(GetTypeHash(K.PaneState), GetTypeHash(K.ImpactCenter)), GetTypeHash(K.bRebuildAllSections));
+		}
+	};
+
+	struct CacheStats
+	{
+		int32 Entries = 0;
+		SIZE_T Bytes = 0;
+		int32 Hits = 0;
+		int32 Misses = 0;
+		int32 Evictions = 0;
+	};
+
+	static FractureResultCache& Get();
+
+	/* Grid pane-local impacts are snapped to before fracturing so nearby hits share results, 0 keeps them as they are */
+	static float GetImpactGrid();
+	static bool IsEnabled();
+
+	TSharedPtr<const FractureJobResult> Find(const Key& InKey);
+
+	/* Takes the result over and returns it shared, whether or not it fit in the cache */
+	TSharedPtr<const FractureJobResult> Add(const Key& InKey, FractureJobResult&& Result);
+	void Reset();
+
+	CacheStats GetStats() const;
+	void ReportStats() const;
+
+private:
+	FractureResultCache();
+
+	void OnWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+#if WITH_EDITOR
+	void OnObjectModified(UObject* Object);
+#endif
+
+	struct Entry
+	{
+		TSharedPtr<const FractureJobResult> Result;
+		SIZE_T Bytes = 0;
+		uint64 LastUsed = 0;
+	};
+
+	TMap<Key, Entry> Entries;
+	SIZE_T TotalBytes = 0;
+	uint64 UseClock = 0;
+	int32 Hits = 0;
+	int32 Misses = 0;
+	int32 Evictions = 0;
+
+	void Evict(int32 MaxEntries, SIZE_T MaxBytes);
+	void PublishStats() const;
+};
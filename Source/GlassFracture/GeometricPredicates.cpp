@@ -0,0 +1,238 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GeometricPredicates.h"
+
+namespace
+{
+	// Nonoverlapping components in increasing magnitude; their exact sum is the represented value
+	using Expansion = TArray<double, TInlineAllocator<32>>;
+
+	constexpr double Epsilon = 1.1102230246251565e-16;		// 2^-53
+	constexpr double Splitter = 134217729.0;					// 2^27 + 1
+
+	// Error bounds of the plain double evaluations, relative to their permanents
+	constexpr double OrientBound = (3.0 + 16.0 * Epsilon) * Epsilon;
+	constexpr double InCircleBound = (10.0 + 96.0 * Epsilon) * Epsilon;
+	constexpr double InDiskBound = (6.0 + 64.0 * Epsilon) * Epsilon;
+
+	FORCEINLINE void TwoSum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		double bv = x - a;
+		double av = x - bv;
+		y = (a - av) + (b - bv);
+	}
+
+	FORCEINLINE void TwoDiff(double a, double b, double& x, double& y)
+	{
+		x = a - b;
+		double bv = a - x;
+		double av = x + bv;
+		y = (a - av) + (bv - b);
+	}
+
+	FORCEINLINE void FastTwoSum(double a, double b, double& x, double& y)
+	{
+		x = a + b;
+		y = b - (x - a);
+	}
+
+	FORCEINLINE void Split(double a, double& hi, double& lo)
+	{
+		double c = Splitter * a;
+		hi = c - (c - a);
+		lo = a - hi;
+	}
+
+	FORCEINLINE void TwoProduct(double a, double b, double& x, double& y)
+	{
+		x = a * b;
+		double ahi, alo, bhi, blo;
+		Split(a, ahi, alo);
+		Split(b, bhi, blo);
+		y = alo * blo - (((x - ahi * bhi) - alo * bhi) - ahi * blo);
+	}
+
+	Expansion Difference(double a, double b)
+	{
+		double x, y;
+		TwoDiff(a, b, x, y);
+
+		Expansion h;
+		if (y != 0.0) {
+			h.Add(y);
+		}
+		h.Add(x);
+		return h;
+	}
+
+	Expansion Grow(const Expansion& e, double b)
+	{
+		Expansion h;
+		double Q = b;
+		for (double enow : e) {
+			double hh;
+			TwoSum(Q, enow, Q, hh);
+			if (hh != 0.0) {
+				h.Add(hh);
+			}
+		}
+		if (Q != 0.0 || h.Num() == 0) {
+			h.Add(Q);
+		}
+		return h;
+	}
+
+	Expansion Sum(const Expansion& e, const Expansion& f)
+	{
+		Expansion h = e;
+		for (double fnow : f) {
+			h = Grow(h, fnow);
+		}
+		return h;
+	}
+
+	Expansion Scale(const Expansion& e, double b)
+	{
+		Expansion h;
+		double Q, hh;
+		TwoProduct(e[0], b, Q, hh);
+		if (hh != 0.0) {
+			h.Add(hh);
+		}
+		for (int32 i = 1; i < e.Num(); ++i) {
+			double product1, product0, sum;
+			TwoProduct(e[i], b, product1, product0);
+			TwoSum(Q, product0, sum, hh);
+			if (hh != 0.0) {
+				h.Add(hh);
+			}
+			FastTwoSum(product1, sum, Q, hh);
+			if (hh != 0.0) {
+				h.Add(hh);
+			}
+		}
+		if (Q != 0.0 || h.Num() == 0) {
+			h.Add(Q);
+		}
+		return h;
+	}
+
+	Expansion Product(const Expansion& e, const Expansion& f)
+	{
+		Expansion h;
+		h.Add(0.0);
+		for (double fnow : f) {
+			h = Sum(h, Scale(e, fnow));
+		}
+		return h;
+	}
+
+	Expansion Negate(Expansion e)
+	{
+		for (double& component : e) {
+			component = -component;
+		}
+		return e;
+	}
+
+	/* The largest component dominates the rest, so the rounded sum has the exact sign */
+	double Estimate(const Expansion& e)
+	{
+		double Total = 0.0;
+		for (double component : e) {
+			Total += component;
+		}
+		return Total;
+	}
+}
+
+double GeometricPredicates::Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	double detleft = (A.X - C.X) * (B.Y - C.Y);
+	double detright = (A.Y - C.Y) * (B.X - C.X);
+	double det = detleft - detright;
+
+	double permanent = FMath::Abs(detleft) + FMath::Abs(detright);
+	if (FMath::Abs(det) >= OrientBound * permanent) {
+		return det;
+	}
+	return Orient2DExact(A, B, C);
+}
+
+double GeometricPredicates::InCircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+{
+	double adx = A.X - D.X, ady = A.Y - D.Y;
+	double bdx = B.X - D.X, bdy = B.Y - D.Y;
+	double cdx = C.X - D.X, cdy = C.Y - D.Y;
+
+	double bdxcdy = bdx * cdy, cdxbdy = cdx * bdy;
+	double cdxady = cdx * ady, adxcdy = adx * cdy;
+	double adxbdy = adx * bdy, bdxady = bdx * ady;
+
+	double alift = adx * adx + ady * ady;
+	double blift = bdx * bdx + bdy * bdy;
+	double clift = cdx * cdx + cdy * cdy;
+
+	double det = alift * (bdxcdy - cdxbdy) + blift * (cdxady - adxcdy) + clift * (adxbdy - bdxady);
+
+	double permanent = (FMath::Abs(bdxcdy) + FMath::Abs(cdxbdy)) * alift
+					 + (FMath::Abs(cdxady) + FMath::Abs(adxcdy)) * blift
+					 + (FMath::Abs(adxbdy) + FMath::Abs(bdxady)) * clift;
+	if (FMath::Abs(det) > InCircleBound * permanent) {
+		return det;
+	}
+	return InCircleExact(A, B, C, D);
+}
+
+double GeometricPredicates::InDisk(const FVector2D& P, const FVector2D& Center, double Radius)
+{
+	double dx = P.X - Center.X;
+	double dy = P.Y - Center.Y;
+	double rr = Radius * Radius;
+	double dd = dx * dx + dy * dy;
+	double det = rr - dd;
+
+	if (FMath::Abs(det) > InDiskBound * (rr + dd)) {
+		return det;
+	}
+	return InDiskExact(P, Center, Radius);
+}
+
+double GeometricPredicates::Orient2DExact(const FVector2D& A, const FVector2D& B, const FVector2D& C)
+{
+	Expansion acx = Difference(A.X, C.X), acy = Difference(A.Y, C.Y);
+	Expansion bcx = Difference(B.X, C.X), bcy = Difference(B.Y, C.Y);
+
+	return Estimate(Sum(Product(acx, bcy), Negate(Product(acy, bcx))));
+}
+
+double GeometricPredicates::InCircleExact(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D)
+{
+	Expansion adx = Difference(A.X, D.X), ady = Difference(A.Y, D.Y);
+	Expansion bdx = Difference(B.X, D.X), bdy = Difference(B.Y, D.Y);
+	Expansion cdx = Difference(C.X, D.X), cdy = Difference(C.Y, D.Y);
+
+	Expansion alift = Sum(Product(adx, adx), Product(ady, ady));
+	Expansion blift = Sum(Product(bdx, bdx), Product(bdy, bdy));
+	Expansion clift = Sum(Product(cdx, cdx), Product(cdy, cdy));
+
+	Expansion bc = Sum(Product(bdx, cdy), Negate(Product(cdx, bdy)));
+	Expansion ca = Sum(Product(cdx, ady), Negate(Product(adx, cdy)));
+	Expansion ab = Sum(Product(adx, bdy), Negate(Product(bdx, ady)));
+
+	return Estimate(Sum(Sum(Product(alift, bc), Product(blift, ca)), Product(clift, ab)));
+}
+
+double GeometricPredicates::InDiskExact(const FVector2D& P, const FVector2D& Center, double Radius)
+{
+	Expansion dx = Difference(P.X, Center.X);
+	Expansion dy = Difference(P.Y, Center.Y);
+
+	double rr, rrtail;
+	TwoProduct(Radius, Radius, rr, rrtail);
+	Expansion r2 = Grow({ rrtail }, rr);
+
+	return Estimate(Sum(r2, Negate(Sum(Product(dx, dx), Product(dy, dy)))));
+}
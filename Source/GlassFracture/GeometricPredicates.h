@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * GeometricPredicates provides adaptive orientation and in-circle tests in the style of Shewchuk.
+ * A floating-point filter answers the common case; only values too close to zero to trust are recomputed with exact expansion arithmetic,
+ * so the sign of every result is exact.
+ */
+class GLASSFRACTURE_API GeometricPredicates
+{
+public:
+	/* Positive when (A, B, C) turn counter-clockwise, negative when clockwise, zero when collinear */
+	static double Orient2D(const FVector2D& A, const FVector2D& B, const FVector2D& C);
+
+	/* Positive when D lies inside the circle through the counter-clockwise triangle (A, B, C), zero when on it */
+	static double InCircle(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D);
+
+	/* Positive when P lies inside the circle of Radius around Center, zero when on it */
+	static double InDisk(const FVector2D& P, const FVector2D& Center, double Radius);
+
+private:
+	static double Orient2DExact(const FVector2D& A, const FVector2D& B, const FVector2D& C);
+	static double InCircleExact(const FVector2D& A, const FVector2D& B, const FVector2D& C, const FVector2D& D);
+	static double InDiskExact(const FVector2D& P, const FVector2D& Center, double Radius);
+};
@@ -4,4 +4,34 @@
 #include "Modules/ModuleManager.h"
 
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, GlassFracture, "GlassFracture" );
- 
\ No newline at end of file
+
+DEFINE_LOG_CATEGORY(LogGlassFracture);
+
+LLM_DEFINE_TAG(GlassFracture);
+
+DEFINE_STAT(STAT_GlassFracture_Job);
+DEFINE_STAT(STAT_GlassFracture_Pattern);
+DEFINE_STAT(STAT_GlassFracture_Refine);
+DEFINE_STAT(STAT_GlassFracture_BroadPhase);
+DEFINE_STAT(STAT_GlassFracture_Clip);
+DEFINE_STAT(STAT_GlassFracture_Classify);
+DEFINE_STAT(STAT_GlassFracture_Hulls);
+DEFINE_STAT(STAT_GlassFracture_Triangulate);
+DEFINE_STAT(STAT_GlassFracture_Apply);
+DEFINE_STAT(STAT_GlassFracture_MeshSections);
+DEFINE_STAT(STAT_GlassFracture_Cook);
+DEFINE_STAT(STAT_GlassFracture_PhysicsState);
+
+DEFINE_STAT(STAT_GlassFracture_ClipCalls);
+DEFINE_STAT(STAT_GlassFracture_PiecesIn);
+DEFINE_STAT(STAT_GlassFracture_PiecesOut);
+DEFINE_STAT(STAT_GlassFracture_ShardsSpawned);
+DEFINE_STAT(STAT_GlassFracture_SectionsRebuilt);
+
+DEFINE_STAT(STAT_GlassFracture_CachedResults);
+DEFINE_STAT(STAT_GlassFracture_CacheMemory);
+DEFINE_STAT(STAT_GlassFracture_CacheHits);
+DEFINE_STAT(STAT_GlassFracture_CacheMisses);
+DEFINE_STAT(STAT_GlassFracture_CacheEvictions);
+
+CSV_DEFINE_CATEGORY_MODULE(GLASSFRACTURE_API, GlassFracture, true);
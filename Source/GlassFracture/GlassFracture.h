@@ -3,3 +3,52 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// Per-hit and per-piece detail is logged as Verbose: "log LogGlassFracture Verbose"
+GLASSFRACTURE_API DECLARE_LOG_CATEGORY_EXTERN(LogGlassFracture, Log, All);
+
+// "stat GlassFracture"; every stage also shows up as a scope in Unreal Insights
+DECLARE_STATS_GROUP(TEXT("GlassFracture"), STATGROUP_GlassFracture, STATCAT_Advanced);
+
+/* Cycle counter for one stage; builds without stats still emit the scope to Insights */
+#if STATS
+#define GLASSFRACTURE_SCOPE(Stage) SCOPE_CYCLE_COUNTER(STAT_GlassFracture_##Stage)
+#else
+#define GLASSFRACTURE_SCOPE(Stage) TRACE_CPUPROFILER_EVENT_SCOPE(GlassFracture_##Stage)
+#endif
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Fracture Job"), STAT_GlassFracture_Job, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Pattern Generation"), STAT_GlassFracture_Pattern, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Refinement"), STAT_GlassFracture_Refine, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Broad Phase"), STAT_GlassFracture_BroadPhase, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Clipping"), STAT_GlassFracture_Clip, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Classification"), STAT_GlassFracture_Classify, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision Hulls"), STAT_GlassFracture_Hulls, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Triangulation"), STAT_GlassFracture_Triangulate, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Fracture"), STAT_GlassFracture_Apply, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Mesh Sections"), STAT_GlassFracture_MeshSections, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Collision Cooking"), STAT_GlassFracture_Cook, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Physics State"), STAT_GlassFracture_PhysicsState, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Clip Calls"), STAT_GlassFracture_ClipCalls, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pieces In"), STAT_GlassFracture_PiecesIn, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Pieces Out"), STAT_GlassFracture_PiecesOut, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Shards Spawned"), STAT_GlassFracture_ShardsSpawned, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Sections Rebuilt"), STAT_GlassFracture_SectionsRebuilt, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+
+// Fracture result cache, running totals since startup
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cached Results"), STAT_GlassFracture_CachedResults, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Cached Result Memory"), STAT_GlassFracture_CacheMemory, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cache Hits"), STAT_GlassFracture_CacheHits, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cache Misses"), STAT_GlassFracture_CacheMisses, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Cache Evictions"), STAT_GlassFracture_CacheEvictions, STATGROUP_GlassFracture, GLASSFRACTURE_API);
+
+// Fracture data, mesh sections, shard components and collision; run with -llm and read "stat LLMFULL" or a memreport
+LLM_DECLARE_TAG_API(GlassFracture, GLASSFRACTURE_API);
+
+// -csvCategories=GlassFracture
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(GLASSFRACTURE_API, GlassFracture);
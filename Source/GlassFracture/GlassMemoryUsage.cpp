@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassMemoryUsage.h"
+#include "ProceduralMeshComponent.h"
+#include "PhysicsEngine/BodySetup.h"
+
+void GlassMemoryUsage::AddPieces(const TArray<Piece>& Pieces)
+{
+	Geometry += Pieces.GetAllocatedSize();
+	for (const Piece& P : Pieces) {
+		Geometry += P.points.GetAllocatedSize() + P.edges.GetAllocatedSize();
+	}
+}
+
+void GlassMemoryUsage::AddBody(const UBodySetup* Body)
+{
+	if (Body) {
+		Collision += const_cast<UBodySetup*>(Body)->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+	}
+}
+
+void GlassMemoryUsage::AddComponent(const UPrimitiveComponent* Component, bool bIncludeBody)
+{
+	if (!IsValid(Component)) {
+		return;
+	}
+	Components += Component->GetClass()->GetStructureSize();
+
+	if (const UProceduralMeshComponent* ProcMesh = Cast<UProceduralMeshComponent>(Component)) {
+		UProceduralMeshComponent* Mesh = const_cast<UProceduralMeshComponent*>(ProcMesh);
+		for (int32 i = 0; i < Mesh->GetNumSections(); ++i) {
+			const FProcMeshSection* Section = Mesh->GetProcMeshSection(i);
+			Render += Section->ProcVertexBuffer.GetAllocatedSize() + Section->ProcIndexBuffer.GetAllocatedSize();
+		}
+	}
+
+	// Only bodies the component owns; shared ones, like a static mesh asset's or the hull cache's, are left to their owner
+	if (bIncludeBody) {
+		const UBodySetup* Body = const_cast<UPrimitiveComponent*>(Component)->GetBodySetup();
+		if (Body && Body->GetOuter() == Component) {
+			AddBody(Body);
+		}
+	}
+}
+
+GlassMemoryUsage& GlassMemoryUsage::operator+=(const GlassMemoryUsage& Other)
+{
+	Geometry += Other.Geometry;
+	Render += Other.Render;
+	Collision += Other.Collision;
+	Components += Other.Components;
+	return *this;
+}
+
+FString GlassMemoryUsage::ToString() const
+{
+	return FString::Printf(TEXT("%.1f KB (geometry %.1f KB, render %.1f KB, collision %.1f KB, components %.1f KB)"),
+		Total() / 1024.0, Geometry / 1024.0, Render / 1024.0, Collision / 1024.0, Components / 1024.0);
+}
@@ -0,0 +1,33 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TriangulationTypes.h"
+
+class UPrimitiveComponent;
+class UBodySetup;
+
+/**
+ * GlassMemoryUsage adds up the bytes held by a pane or by the shard pool, split the way memreports are read.
+ * Sizes are allocated sizes of the CPU-side arrays; the render thread keeps its own copy of mesh sections on top of Render.
+ */
+struct GLASSFRACTURE_API GlassMemoryUsage
+{
+	SIZE_T Geometry = 0;	// Pieces and pattern cells, each with its points and edges
+	SIZE_T Render = 0;		// Procedural mesh section buffers
+	SIZE_T Collision = 0;	// Body setups with their hulls and cooked meshes
+	SIZE_T Components = 0;	// Component objects
+
+	SIZE_T Total() const { return Geometry + Render + Collision + Components; }
+
+	void AddPieces(const TArray<Piece>& Pieces);
+	void AddBody(const UBodySetup* Body);
+
+	/* Counts the body only when the component owns it; shards pass bIncludeBody false, the hull cache counts theirs */
+	void AddComponent(const UPrimitiveComponent* Component, bool bIncludeBody = true);
+
+	GlassMemoryUsage& operator+=(const GlassMemoryUsage& Other);
+
+	FString ToString() const;
+};
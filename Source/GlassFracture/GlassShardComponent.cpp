@@ -0,0 +1,19 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassShardComponent.h"
+
+void UGlassShardComponent::SetSharedBodySetup(UBodySetup* InBodySetup)
+{
+	if (SharedBodySetup == InBodySetup)
+	{
+		return;
+	}
+	SharedBodySetup = InBodySetup;
+	RecreatePhysicsState();
+}
+
+UBodySetup* UGlassShardComponent::GetBodySetup()
+{
+	return SharedBodySetup ? SharedBodySetup : Super::GetBodySetup();
+}
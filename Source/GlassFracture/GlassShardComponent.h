@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "GlassShardComponent.generated.h"
+
+/**
+ * Procedural mesh used as a falling shard. Its collision is a cooked body shared by every shard of the same shape,
+ * handed out by the shard subsystem, so a shard never cooks collision of its own.
+ */
+UCLASS()
+class GLASSFRACTURE_API UGlassShardComponent : public UProceduralMeshComponent
+{
+	GENERATED_BODY()
+
+public:
+	/* Null falls back to the component's own, empty body setup */
+	void SetSharedBodySetup(UBodySetup* InBodySetup);
+	UBodySetup* GetSharedBodySetup() const { return SharedBodySetup; }
+
+	virtual UBodySetup* GetBodySetup() override;
+
+private:
+	UPROPERTY(Transient)
+	UBodySetup* SharedBodySetup = nullptr;
+};
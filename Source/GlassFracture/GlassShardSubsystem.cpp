@@ -0,0 +1,617 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassShardSubsystem.h"
+#include "GlassFracture.h"
+#include "ShatterableGlass.h"
+#include "FractureResultCache.h"
+#include "EngineUtils.h"
+#include "GameFramework/WorldSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "Camera/PlayerCameraManager.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Hash/CityHash.h"
+
+namespace
+{
+	// Hull vertices closer than this are treated as equal when looking up cached bodies
+	constexpr double HullCacheResolution = 0.01;
+
+	FIntVector QuantizeHullVertex(const FVector& V)
+	{
+		return FIntVector(FMath::RoundToInt32(V.X / HullCacheResolution), FMath::RoundToInt32(V.Y / HullCacheResolution), FMath::RoundToInt32(V.Z / HullCacheResolution));
+	}
+
+	bool VertexLess(const FIntVector& A, const FIntVector& B)
+	{
+		return A.X != B.X ? A.X < B.X : (A.Y != B.Y ? A.Y < B.Y : A.Z < B.Z);
+	}
+
+	bool HullLess(const TArray<FIntVector>& A, const TArray<FIntVector>& B)
+	{
+		if (A.Num() != B.Num())
+		{
+			return A.Num() < B.Num();
+		}
+		for (int32 i = 0; i < A.Num(); ++i)
+		{
+			if (A[i] != B[i])
+			{
+				return VertexLess(A[i], B[i]);
+			}
+		}
+		return false;
+	}
+}
+
+static TAutoConsoleVariable<int32> CVarShardPoolWarmup(
+	TEXT("glass.ShardPool.Warmup"), 64,
+	TEXT("Shard components created ahead of the first hit."));
+
+static TAutoConsoleVariable<int32> CVarShardPoolWarmupPerFrame(
+	TEXT("glass.ShardPool.WarmupPerFrame"), 8,
+	TEXT("Shard components created per frame while warming up."));
+
+static TAutoConsoleVariable<int32> CVarShardPoolMaxFree(
+	TEXT("glass.ShardPool.MaxFree"), 256,
+	TEXT("Free shard components kept for reuse; shards released beyond this are destroyed."));
+
+static TAutoConsoleVariable<float> CVarShardLifetime(
+	TEXT("glass.Shard.Lifetime"), 20.0f,
+	TEXT("Seconds before a shard returns to the pool, 0 keeps it until it falls below KillZ."));
+
+static TAutoConsoleVariable<int32> CVarShardMaxLive(
+	TEXT("glass.Shard.MaxLive"), 200,
+	TEXT("Most shards alive across all panes, 0 for no cap."));
+
+static TAutoConsoleVariable<int32> CVarShardMaxSimulating(
+	TEXT("glass.Shard.MaxSimulating"), 64,
+	TEXT("Most shards simulating physics across all panes, 0 for no cap. Shards over the cap are frozen as static debris."));
+
+static TAutoConsoleVariable<int32> CVarShardRetirePolicy(
+	TEXT("glass.Shard.RetirePolicy"), 0,
+	TEXT("Order in which shards are retired or frozen when over budget: 0 sleeping first, 1 oldest, 2 smallest, 3 farthest."));
+
+static TAutoConsoleVariable<int32> CVarHullCacheMaxEntries(
+	TEXT("glass.HullCache.MaxEntries"), 512,
+	TEXT("Cooked shard shapes kept for reuse; the least recently used are dropped beyond this."));
+
+static TAutoConsoleVariable<float> CVarMemorySampleInterval(
+	TEXT("glass.Memory.SampleInterval"), 1.0f,
+	TEXT("Seconds between world memory samples feeding the peak, 0 samples only on glass.Memory.Dump. Each sample walks every pane and shard."));
+
+static FAutoConsoleCommandWithWorld CmdShardPoolReport(
+	TEXT("glass.ShardPool.Report"),
+	TEXT("Logs the shard pool size, live shards and high-water mark."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		if (UGlassShardSubsystem* Shards = World ? World->GetSubsystem<UGlassShardSubsystem>() : nullptr)
+		{
+			Shards->ReportStats();
+		}
+	}));
+
+static FAutoConsoleCommandWithWorld CmdMemoryDump(
+	TEXT("glass.Memory.Dump"),
+	TEXT("Logs the memory held by each glass pane and the shard pool by category, with world totals and peaks."),
+	FConsoleCommandWithWorldDelegate::CreateStatic([](UWorld* World)
+	{
+		if (UGlassShardSubsystem* Shards = World ? World->GetSubsystem<UGlassShardSubsystem>() : nullptr)
+		{
+			Shards->DumpMemory();
+		}
+	}));
+
+bool UGlassShardSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UGlassShardSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	WarmupTarget = FMath::Max(CVarShardPoolWarmup.GetValueOnGameThread(), 0);
+}
+
+void UGlassShardSubsystem::Deinitialize()
+{
+	ReportStats();
+
+	FreeShards.Empty();
+	LiveShards.Empty();
+	LiveSince.Empty();
+	PendingLaunches.Empty();
+	CookingBodies.Empty();
+	HullBodies.Empty();
+	HullEntries.Empty();
+	PoolOwner = nullptr;
+
+	Super::Deinitialize();
+}
+
+TStatId UGlassShardSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGlassShardSubsystem, STATGROUP_Tickables);
+}
+
+void UGlassShardSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Spread warmup over several frames so level start does not hitch
+	const int32 PerFrame = FMath::Max(CVarShardPoolWarmupPerFrame.GetValueOnGameThread(), 1);
+	for (int32 i = 0; i < PerFrame && FreeShards.Num() + LiveShards.Num() < WarmupTarget; ++i)
+	{
+		FreeShards.Add(CreateShard());
+	}
+
+	const double Now = GetWorld()->GetTimeSeconds();
+	const double Lifetime = CVarShardLifetime.GetValueOnGameThread();
+	const AWorldSettings* WorldSettings = GetWorld()->GetWorldSettings();
+	const double KillZ = WorldSettings ? WorldSettings->KillZ : -UE_BIG_NUMBER;
+
+	for (int32 i = LiveShards.Num() - 1; i >= 0; --i)
+	{
+		UGlassShardComponent* Shard = LiveShards[i];
+		if (!IsValid(Shard))
+		{
+			RemoveLiveShard(i);
+			continue;
+		}
+
+		const bool bExpired = Lifetime > 0.0 && Now - LiveSince[i] > Lifetime;
+		if (bExpired || Shard->GetComponentLocation().Z < KillZ)
+		{
+			ReleaseAt(i);
+		}
+	}
+
+	EnforceBudget();
+
+	// Sampled on a timer rather than per hit, a sample costs O(panes + shards)
+	const float SampleInterval = CVarMemorySampleInterval.GetValueOnGameThread();
+	if (SampleInterval > 0.0f && Now - LastMemorySampleTime >= SampleInterval)
+	{
+		LastMemorySampleTime = Now;
+		SampleWorldMemory();
+	}
+}
+
+void UGlassShardSubsystem::EnforceBudget()
+{
+	const int32 MaxLive = CVarShardMaxLive.GetValueOnGameThread();
+	if (MaxLive > 0 && LiveShards.Num() > MaxLive)
+	{
+		TArray<int32> Ranked;
+		for (int32 i = 0; i < LiveShards.Num(); ++i)
+		{
+			Ranked.Add(i);
+		}
+		RankShards(Ranked);
+
+		// Release from the highest index down so RemoveAtSwap never moves a shard still to be released
+		TArray<int32> ToRelease(Ranked.GetData(), LiveShards.Num() - MaxLive);
+		ToRelease.Sort(TGreater<int32>());
+		for (int32 Index : ToRelease)
+		{
+			ReleaseAt(Index);
+			Retired++;
+		}
+	}
+
+	const int32 MaxSimulating = CVarShardMaxSimulating.GetValueOnGameThread();
+	if (MaxSimulating > 0)
+	{
+		TArray<int32> Simulating;
+		for (int32 i = 0; i < LiveShards.Num(); ++i)
+		{
+			if (LiveShards[i]->IsSimulatingPhysics())
+			{
+				Simulating.Add(i);
+			}
+		}
+		if (Simulating.Num() > MaxSimulating)
+		{
+			RankShards(Simulating);
+			for (int32 k = 0; k < Simulating.Num() - MaxSimulating; ++k)
+			{
+				UGlassShardComponent* Shard = LiveShards[Simulating[k]];
+				Shard->SetSimulatePhysics(false);
+				Shard->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+				Frozen++;
+			}
+		}
+	}
+}
+
+/* Sorts Indices into LiveShards so the shard to give up first comes first */
+void UGlassShardSubsystem::RankShards(TArray<int32>& Indices) const
+{
+	const ERetirePolicy Policy = (ERetirePolicy)FMath::Clamp(CVarShardRetirePolicy.GetValueOnGameThread(), 0, 3);
+
+	FVector ViewLocation = FVector::ZeroVector;
+	const APlayerController* PlayerController = GetWorld()->GetFirstPlayerController();
+	if (PlayerController && PlayerController->PlayerCameraManager)
+	{
+		ViewLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	}
+
+	// Smaller key goes first; computed once per shard rather than per comparison
+	TArray<double> Keys;
+	Keys.SetNumUninitialized(LiveShards.Num());
+	for (int32 Index : Indices)
+	{
+		const UGlassShardComponent* Shard = LiveShards[Index];
+		switch (Policy)
+		{
+		case ERetirePolicy::SleepingFirst:
+			Keys[Index] = LiveSince[Index] + (Shard->IsSimulatingPhysics() && Shard->RigidBodyIsAwake() ? UE_BIG_NUMBER : 0.0);
+			break;
+		case ERetirePolicy::Oldest:
+			Keys[Index] = LiveSince[Index];
+			break;
+		case ERetirePolicy::Smallest:
+			Keys[Index] = Shard->Bounds.SphereRadius;
+			break;
+		case ERetirePolicy::Farthest:
+			Keys[Index] = -FVector::DistSquared(Shard->GetComponentLocation(), ViewLocation);
+			break;
+		}
+	}
+
+	Indices.Sort([&Keys](int32 A, int32 B) {
+		return Keys[A] < Keys[B];
+	});
+}
+
+UGlassShardComponent* UGlassShardSubsystem::AcquireShard(const FTransform& Transform)
+{
+	LLM_SCOPE_BYTAG(GlassFracture);
+	UGlassShardComponent* Shard = nullptr;
+	while (!Shard && FreeShards.Num() > 0)
+	{
+		Shard = FreeShards.Pop(false);
+		Shard = IsValid(Shard) ? Shard : nullptr;
+	}
+	if (!Shard)
+	{
+		Misses++;
+		Shard = CreateShard();
+	}
+
+	Shard->SetWorldTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Shard->SetVisibility(true);
+
+	LiveShards.Add(Shard);
+	LiveSince.Add(GetWorld()->GetTimeSeconds());
+	HighWater = FMath::Max(HighWater, LiveShards.Num());
+
+	return Shard;
+}
+
+void UGlassShardSubsystem::ReleaseShard(UGlassShardComponent* Shard)
+{
+	const int32 Index = LiveShards.Find(Shard);
+	if (Index != INDEX_NONE)
+	{
+		ReleaseAt(Index);
+	}
+}
+
+void UGlassShardSubsystem::ReleaseAt(int32 Index)
+{
+	UGlassShardComponent* Shard = LiveShards[Index];
+	RemoveLiveShard(Index);
+
+	if (FreeShards.Num() >= CVarShardPoolMaxFree.GetValueOnGameThread())
+	{
+		Shard->DestroyComponent();
+		return;
+	}
+
+	ResetShard(Shard);
+	FreeShards.Add(Shard);
+}
+
+UBodySetup* UGlassShardSubsystem::FindOrCookHulls(const TArray<TArray<FVector>>& Hulls, FVector& OutOrigin)
+{
+	LLM_SCOPE_BYTAG(GlassFracture);
+	FBox Bounds(ForceInit);
+	int32 NumVertices = 0;
+	for (const TArray<FVector>& Hull : Hulls)
+	{
+		Bounds += FBox(Hull);
+		NumVertices += Hull.Num();
+	}
+	OutOrigin = Bounds.IsValid ? Bounds.Min : FVector::ZeroVector;
+
+	// Hulls are point sets: vertices are sorted within each hull and hulls sorted among themselves, each led by its size
+	TArray<TArray<FIntVector>> QuantizedHulls;
+	QuantizedHulls.SetNum(Hulls.Num());
+	for (int32 h = 0; h < Hulls.Num(); ++h)
+	{
+		QuantizedHulls[h].Reserve(Hulls[h].Num());
+		for (const FVector& V : Hulls[h])
+		{
+			QuantizedHulls[h].Add(QuantizeHullVertex(V - OutOrigin));
+		}
+		QuantizedHulls[h].Sort(&VertexLess);
+	}
+	QuantizedHulls.Sort(&HullLess);
+
+	TArray<FIntVector> Shape;
+	Shape.Reserve(NumVertices + Hulls.Num());
+	for (const TArray<FIntVector>& Hull : QuantizedHulls)
+	{
+		Shape.Add(FIntVector(Hull.Num(), 0, 0));
+		Shape.Append(Hull);
+	}
+	const uint64 Key = CityHash64((const char*)Shape.GetData(), Shape.Num() * sizeof(FIntVector));
+
+	HullCacheEntry* Entry = HullEntries.Find(Key);
+	if (Entry && Entry->Shape == Shape)
+	{
+		HullHits++;
+		Entry->LastUsed = GFrameCounter;
+		return HullBodies.FindChecked(Key);
+	}
+
+	// A different shape under the same key is replaced; shards already using its body keep it alive
+	HullMisses++;
+	if (Entry)
+	{
+		HullEntries.Remove(Key);
+		HullBodies.Remove(Key);
+	}
+	EvictHulls(FMath::Max(CVarHullCacheMaxEntries.GetValueOnGameThread() - 1, 0));
+
+	UBodySetup* Body = CookHulls(Hulls, OutOrigin);
+	HullBodies.Add(Key, Body);
+	HullEntries.Add(Key, { MoveTemp(Shape), GFrameCounter });
+	return Body;
+}
+
+void UGlassShardSubsystem::LaunchShard(UGlassShardComponent* Shard, UBodySetup* Body, const FVector& Impulse)
+{
+	if (Body->bCreatedPhysicsMeshes)
+	{
+		StartSimulating(Shard, Body, Impulse);
+		return;
+	}
+	PendingLaunches.Add({ Shard, Body, Impulse });
+}
+
+UBodySetup* UGlassShardSubsystem::CookHulls(const TArray<TArray<FVector>>& Hulls, const FVector& Origin)
+{
+	GLASSFRACTURE_SCOPE(Cook);
+	UBodySetup* Body = NewObject<UBodySetup>(this, NAME_None, RF_Transient);
+	Body->BodySetupGuid = FGuid::NewGuid();
+	Body->bGenerateMirroredCollision = false;
+	Body->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+
+	for (const TArray<FVector>& Hull : Hulls)
+	{
+		FKConvexElem& Elem = Body->AggGeom.ConvexElems.AddDefaulted_GetRef();
+		Elem.VertexData.Reserve(Hull.Num());
+		for (const FVector& V : Hull)
+		{
+			Elem.VertexData.Add(V - Origin);
+		}
+		Elem.UpdateElemBox();
+	}
+
+	CookingBodies.Add(Body);
+	Body->CreatePhysicsMeshesAsync(FOnAsyncPhysicsCookFinished::CreateUObject(this, &UGlassShardSubsystem::OnHullsCooked, Body));
+	return Body;
+}
+
+void UGlassShardSubsystem::OnHullsCooked(bool bSuccess, UBodySetup* Body)
+{
+	LLM_SCOPE_BYTAG(GlassFracture);
+	CookingBodies.RemoveSingleSwap(Body, false);
+
+	// A failed body never gets its physics meshes, so later matches would wait on it forever; the next hit cooks afresh
+	if (!bSuccess)
+	{
+		if (const uint64* Key = HullBodies.FindKey(Body))
+		{
+			const uint64 FailedKey = *Key;
+			HullBodies.Remove(FailedKey);
+			HullEntries.Remove(FailedKey);
+		}
+		UE_LOG(LogGlassFracture, Warning, TEXT("Shard hull cooking failed, dropped the cached shape"));
+	}
+
+	// Copied out first: a failed launch releases its shard, which edits PendingLaunches
+	TArray<PendingLaunch> Ready;
+	for (int32 i = PendingLaunches.Num() - 1; i >= 0; --i)
+	{
+		if (PendingLaunches[i].Body == Body)
+		{
+			Ready.Add(PendingLaunches[i]);
+			PendingLaunches.RemoveAtSwap(i, 1, false);
+		}
+	}
+
+	for (const PendingLaunch& Launch : Ready)
+	{
+		if (bSuccess)
+		{
+			StartSimulating(Launch.Shard, Body, Launch.Impulse);
+		}
+		else
+		{
+			ReleaseShard(Launch.Shard);
+		}
+	}
+}
+
+void UGlassShardSubsystem::EvictHulls(int32 MaxEntries)
+{
+	while (HullEntries.Num() > MaxEntries)
+	{
+		uint64 Oldest = 0;
+		uint64 OldestUse = MAX_uint64;
+		for (const TPair<uint64, HullCacheEntry>& Pair : HullEntries)
+		{
+			if (Pair.Value.LastUsed < OldestUse)
+			{
+				OldestUse = Pair.Value.LastUsed;
+				Oldest = Pair.Key;
+			}
+		}
+
+		// Shards still using the body keep it alive through their own reference
+		HullEntries.Remove(Oldest);
+		HullBodies.Remove(Oldest);
+	}
+}
+
+void UGlassShardSubsystem::StartSimulating(UGlassShardComponent* Shard, UBodySetup* Body, const FVector& Impulse)
+{
+	GLASSFRACTURE_SCOPE(PhysicsState);
+	LLM_SCOPE_BYTAG(GlassFracture);
+	Shard->SetSharedBodySetup(Body);
+	Shard->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
+	Shard->SetSimulatePhysics(true);
+	Shard->AddImpulse(Impulse, NAME_None, true);
+	Shard->WakeRigidBody();
+}
+
+UGlassShardSubsystem::PoolStats UGlassShardSubsystem::GetStats() const
+{
+	PoolStats Stats;
+	Stats.Free = FreeShards.Num();
+	Stats.Live = LiveShards.Num();
+	Stats.HighWater = HighWater;
+	Stats.Created = Created;
+	Stats.Misses = Misses;
+	Stats.Retired = Retired;
+	Stats.Frozen = Frozen;
+	Stats.CachedHulls = HullEntries.Num();
+	Stats.HullHits = HullHits;
+	Stats.HullMisses = HullMisses;
+	for (const UGlassShardComponent* Shard : LiveShards)
+	{
+		Stats.Simulating += (IsValid(Shard) && Shard->IsSimulatingPhysics()) ? 1 : 0;
+	}
+	return Stats;
+}
+
+void UGlassShardSubsystem::ReportStats() const
+{
+	const PoolStats Stats = GetStats();
+	UE_LOG(LogGlassFracture, Log, TEXT("Shard pool: %d free, %d live (%d simulating), high-water %d, %d created, %d misses, %d retired, %d frozen"),
+		Stats.Free, Stats.Live, Stats.Simulating, Stats.HighWater, Stats.Created, Stats.Misses, Stats.Retired, Stats.Frozen);
+	UE_LOG(LogGlassFracture, Log, TEXT("Shard hull cache: %d shapes, %d hits, %d cooked"), Stats.CachedHulls, Stats.HullHits, Stats.HullMisses);
+}
+
+GlassMemoryUsage UGlassShardSubsystem::GetMemoryUsage() const
+{
+	GlassMemoryUsage Usage;
+	for (const TArray<UGlassShardComponent*>* Shards : { &FreeShards, &LiveShards })
+	{
+		for (const UGlassShardComponent* Shard : *Shards)
+		{
+			Usage.AddComponent(Shard, false);
+		}
+	}
+	Usage.Components += FreeShards.GetAllocatedSize() + LiveShards.GetAllocatedSize() + LiveSince.GetAllocatedSize();
+
+	for (const TPair<uint64, UBodySetup*>& Pair : HullBodies)
+	{
+		Usage.AddBody(Pair.Value);
+	}
+	// Evicted while still cooking
+	for (UBodySetup* Body : CookingBodies)
+	{
+		if (!HullBodies.FindKey(Body))
+		{
+			Usage.AddBody(Body);
+		}
+	}
+	Usage.Collision += HullBodies.GetAllocatedSize() + HullEntries.GetAllocatedSize() + PendingLaunches.GetAllocatedSize();
+	for (const TPair<uint64, HullCacheEntry>& Pair : HullEntries)
+	{
+		Usage.Collision += Pair.Value.Shape.GetAllocatedSize();
+	}
+	return Usage;
+}
+
+GlassMemoryUsage UGlassShardSubsystem::SampleWorldMemory()
+{
+	GlassMemoryUsage World = GetMemoryUsage();
+	for (TActorIterator<AShatterableGlass> It(GetWorld()); It; ++It)
+	{
+		World += It->GetMemoryUsage();
+	}
+	if (World.Total() > PeakWorldMemory.Total())
+	{
+		PeakWorldMemory = World;
+	}
+	return World;
+}
+
+void UGlassShardSubsystem::DumpMemory()
+{
+	for (TActorIterator<AShatterableGlass> It(GetWorld()); It; ++It)
+	{
+		UE_LOG(LogGlassFracture, Log, TEXT("%s: %s, peak %.1f KB"), *It->GetName(), *It->GetMemoryUsage().ToString(), It->GetPeakMemoryUsage().Total() / 1024.0);
+	}
+	UE_LOG(LogGlassFracture, Log, TEXT("Shard pool: %s"), *GetMemoryUsage().ToString());
+	FractureResultCache::Get().ReportStats();
+
+	const GlassMemoryUsage World = SampleWorldMemory();
+	UE_LOG(LogGlassFracture, Log, TEXT("World: %s"), *World.ToString());
+	UE_LOG(LogGlassFracture, Log, TEXT("World peak: %s"), *PeakWorldMemory.ToString());
+}
+
+UGlassShardComponent* UGlassShardSubsystem::CreateShard()
+{
+	LLM_SCOPE_BYTAG(GlassFracture);
+	if (!PoolOwner)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Name = TEXT("GlassShardPool");
+		SpawnParams.ObjectFlags |= RF_Transient;
+		PoolOwner = GetWorld()->SpawnActor<AActor>(SpawnParams);
+	}
+
+	UGlassShardComponent* Shard = NewObject<UGlassShardComponent>(PoolOwner);
+
+	// Collision setup is the same for every shard, so it is done once here instead of per hit
+	Shard->SetCollisionProfileName(TEXT("BlockAll"));
+	Shard->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
+	Shard->SetCollisionObjectType(ECollisionChannel::ECC_PhysicsBody);
+	Shard->bUseComplexAsSimpleCollision = false;
+	Shard->bAlwaysCreatePhysicsState = true;
+
+	Shard->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Shard->SetVisibility(false);
+	Shard->RegisterComponent();
+	PoolOwner->AddInstanceComponent(Shard);
+
+	Created++;
+	return Shard;
+}
+
+void UGlassShardSubsystem::ResetShard(UGlassShardComponent* Shard)
+{
+	Shard->SetSimulatePhysics(false);
+	Shard->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Shard->SetSharedBodySetup(nullptr);
+	Shard->ClearAllMeshSections();
+	Shard->SetVisibility(false);
+}
+
+void UGlassShardSubsystem::RemoveLiveShard(int32 Index)
+{
+	const UGlassShardComponent* Shard = LiveShards[Index];
+	PendingLaunches.RemoveAllSwap([Shard](const PendingLaunch& Launch) {
+		return Launch.Shard == Shard;
+	});
+
+	LiveShards.RemoveAtSwap(Index, 1, false);
+	LiveSince.RemoveAtSwap(Index, 1, false);
+}
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GlassShardComponent.h"
+#include "GlassMemoryUsage.h"
+#include "GlassShardSubsystem.generated.h"
+
+/**
+ * Pool of registered procedural mesh components used as falling glass shards by every pane in the world.
+ * Components are created ahead of the first hit, a few per frame, and go back to the pool when they expire or fall below KillZ.
+ * It also enforces a world-wide budget: past the live cap shards are retired early, past the simulating cap they are frozen in place.
+ * Shard collision is cooked asynchronously into bodies cached by shape, so repeated cells reuse a body instead of cooking again.
+ */
+UCLASS()
+class GLASSFRACTURE_API UGlassShardSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	struct PoolStats
+	{
+		int32 Free = 0;
+		int32 Live = 0;
+		int32 HighWater = 0;	// Most shards live at once
+		int32 Created = 0;
+		int32 Misses = 0;		// Acquires that found the pool empty
+		int32 Simulating = 0;
+		int32 Retired = 0;		// Released early to stay under the live cap
+		int32 Frozen = 0;		// Turned into static debris to stay under the simulating cap
+		int32 CachedHulls = 0;
+		int32 HullHits = 0;
+		int32 HullMisses = 0;	// Shapes that had to be cooked
+	};
+
+	/* Which shards go first when over budget */
+	enum class ERetirePolicy : int32
+	{
+		SleepingFirst,	// Resting or frozen shards, then the oldest
+		Oldest,
+		Smallest,
+		Farthest		// From the first player's camera
+	};
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/* Visible shard at Transform with no geometry and no collision; the caller builds it and hands it to LaunchShard */
+	UGlassShardComponent* AcquireShard(const FTransform& Transform);
+	void ReleaseShard(UGlassShardComponent* Shard);
+
+	/**
+	 * Cooked collision for a shard made of Hulls. The hulls are moved so their min corner, returned in OutOrigin, is the shard's origin;
+	 * shapes equal up to that translation share one body. A new shape starts cooking off the game thread.
+	 */
+	UBodySetup* FindOrCookHulls(const TArray<TArray<FVector>>& Hulls, FVector& OutOrigin);
+
+	/* Turns on collision and simulation and applies Impulse once Body is cooked, right away when it already is */
+	void LaunchShard(UGlassShardComponent* Shard, UBodySetup* Body, const FVector& Impulse);
+
+	PoolStats GetStats() const;
+	void ReportStats() const;
+
+	/* Bytes held by the pool: every shard component and its sections, plus the hull cache */
+	GlassMemoryUsage GetMemoryUsage() const;
+
+	/* Every pane in the world plus the pool; also raises the world peak. Walks every pane and shard, so Tick only calls it every glass.Memory.SampleInterval */
+	GlassMemoryUsage SampleWorldMemory();
+	const GlassMemoryUsage& GetPeakWorldMemory() const { return PeakWorldMemory; }
+	void DumpMemory();
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	UPROPERTY()
+	AActor* PoolOwner = nullptr;
+
+	UPROPERTY()
+	TArray<UGlassShardComponent*> FreeShards;
+
+	UPROPERTY()
+	TArray<UGlassShardComponent*> LiveShards;
+	TArray<double> LiveSince;	// Parallel to LiveShards
+
+	struct HullCacheEntry
+	{
+		TArray<FIntVector> Shape;	// Canonical quantized vertices, compared on lookup so colliding keys never share a body
+		uint64 LastUsed = 0;
+	};
+
+	struct PendingLaunch
+	{
+		UGlassShardComponent* Shard = nullptr;
+		UBodySetup* Body = nullptr;
+		FVector Impulse = FVector::ZeroVector;
+	};
+
+	// Keyed by the translation-normalized shape of the hulls
+	UPROPERTY()
+	TMap<uint64, UBodySetup*> HullBodies;
+	TMap<uint64, HullCacheEntry> HullEntries;
+
+	// Bodies still cooking, kept here so they outlive eviction from the cache
+	UPROPERTY()
+	TArray<UBodySetup*> CookingBodies;
+	TArray<PendingLaunch> PendingLaunches;
+
+	int32 WarmupTarget = 0;
+	int32 HighWater = 0;
+	int32 Created = 0;
+	int32 Misses = 0;
+	int32 Retired = 0;
+	int32 Frozen = 0;
+	int32 HullHits = 0;
+	int32 HullMisses = 0;
+	GlassMemoryUsage PeakWorldMemory;
+	double LastMemorySampleTime = 0.0;
+
+	void EnforceBudget();
+	void RankShards(TArray<int32>& Indices) const;
+	void ReleaseAt(int32 Index);
+
+	UGlassShardComponent* CreateShard();
+	void ResetShard(UGlassShardComponent* Shard);
+	void RemoveLiveShard(int32 Index);
+
+	UBodySetup* CookHulls(const TArray<TArray<FVector>>& Hulls, const FVector& Origin);
+	void OnHullsCooked(bool bSuccess, UBodySetup* Body);
+	void EvictHulls(int32 MaxEntries);
+	static void StartSimulating(UGlassShardComponent* Shard, UBodySetup* Body, const FVector& Impulse);
+};
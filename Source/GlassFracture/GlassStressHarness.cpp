@@ -0,0 +1,335 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassStressHarness.h"
+#include "GlassFracture.h"
+#include "GlassShardSubsystem.h"
+#include "ShatterableGlass.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static FAutoConsoleCommandWithWorldAndArgs CmdStressRun(
+	TEXT("glass.Stress.Run"),
+	TEXT("Spawns a grid of glass panes, hits them in scripted volleys and writes frame-time percentiles as JSON, then quits. ")
+	TEXT("Args: Panes=<n> Volleys=<n> Hits=<n> Seed=<n> Class=<pane blueprint class path> Output=<file>"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateStatic([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+		const FString Params = FString::Join(Args, TEXT(" "));
+
+		AGlassStressHarness* Harness = World->SpawnActorDeferred<AGlassStressHarness>(AGlassStressHarness::StaticClass(), FTransform::Identity);
+		FParse::Value(*Params, TEXT("Panes="), Harness->NumPanes);
+		FParse::Value(*Params, TEXT("Volleys="), Harness->NumVolleys);
+		FParse::Value(*Params, TEXT("Hits="), Harness->HitsPerVolley);
+		FParse::Value(*Params, TEXT("Seed="), Harness->Seed);
+		FParse::Value(*Params, TEXT("Output="), Harness->OutputFile);
+		FParse::Value(*Params, TEXT("FrameBudget="), Harness->FrameBudgetMs);
+		FParse::Value(*Params, TEXT("PhysicsBudget="), Harness->PhysicsBudgetMs);
+
+		FString ClassPath;
+		if (FParse::Value(*Params, TEXT("Class="), ClassPath))
+		{
+			if (UClass* PaneClass = LoadClass<AShatterableGlass>(nullptr, *ClassPath))
+			{
+				Harness->PaneClass = PaneClass;
+			}
+			else
+			{
+				UE_LOG(LogGlassFracture, Warning, TEXT("Stress run: %s is not a glass pane class, using the default"), *ClassPath);
+			}
+		}
+
+		Harness->bRunOnBeginPlay = true;
+		Harness->FinishSpawning(FTransform::Identity);
+	}));
+
+AGlassStressHarness::AGlassStressHarness()
+{
+	// Ticks before physics so each frame is measured from the same point
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PrePhysics;
+
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	PaneClass = AShatterableGlass::StaticClass();
+}
+
+void AGlassStressHarness::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (FPhysScene* Scene = GetWorld()->GetPhysicsScene())
+	{
+		PhysicsPreTickHandle = Scene->OnPhysScenePreTick.AddUObject(this, &AGlassStressHarness::OnPhysicsPreTick);
+		PhysicsPostTickHandle = Scene->OnPhysScenePostTick.AddUObject(this, &AGlassStressHarness::OnPhysicsPostTick);
+	}
+
+	if (bRunOnBeginPlay)
+	{
+		StartRun();
+	}
+}
+
+void AGlassStressHarness::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (FPhysScene* Scene = GetWorld()->GetPhysicsScene())
+	{
+		Scene->OnPhysScenePreTick.Remove(PhysicsPreTickHandle);
+		Scene->OnPhysScenePostTick.Remove(PhysicsPostTickHandle);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGlassStressHarness::StartRun()
+{
+	Stream.Initialize(Seed);
+	GameThreadMs.Reset();
+	PhysicsMs.Reset();
+	FrameMs.Reset();
+	PeakLiveShards = 0;
+	PeakSimulatingShards = 0;
+	PeakCachedBodies = 0;
+	VolleysFired = 0;
+	HitsFired = 0;
+
+	SpawnPanes();
+
+	Phase = EPhase::Warmup;
+	PhaseStartTime = FPlatformTime::Seconds();
+	LastFrameTime = PhaseStartTime;
+	SetActorTickEnabled(true);
+
+	UE_LOG(LogGlassFracture, Log, TEXT("Stress run: %d panes, %d volleys of %d hits, seed %d"), Panes.Num(), NumVolleys, HitsPerVolley, Seed);
+}
+
+/* Square grid in the X/Y plane, panes facing Y like a placed pane */
+void AGlassStressHarness::SpawnPanes()
+{
+	for (AShatterableGlass* Pane : Panes)
+	{
+		if (IsValid(Pane))
+		{
+			Pane->Destroy();
+		}
+	}
+	Panes.Reset(NumPanes);
+
+	const int32 Columns = FMath::CeilToInt32(FMath::Sqrt((float)NumPanes));
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 i = 0; i < NumPanes; ++i)
+	{
+		const FVector Offset((i % Columns) * PaneSpacing, (i / Columns) * PaneSpacing, 0.0);
+		const FTransform Transform(GetActorRotation(), GetActorLocation() + GetActorRotation().RotateVector(Offset));
+		if (AShatterableGlass* Pane = GetWorld()->SpawnActor<AShatterableGlass>(PaneClass, Transform, SpawnParams))
+		{
+			Panes.Add(Pane);
+		}
+	}
+}
+
+void AGlassStressHarness::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const double Now = FPlatformTime::Seconds();
+	if (Phase == EPhase::Volleys || Phase == EPhase::Settle)
+	{
+		RecordFrame(Now);
+	}
+	LastFrameTime = Now;
+
+	switch (Phase)
+	{
+	case EPhase::Warmup:
+		if (Now - PhaseStartTime >= WarmupSeconds)
+		{
+			Phase = EPhase::Volleys;
+			PhaseStartTime = Now;
+			FireVolley();
+		}
+		break;
+	case EPhase::Volleys:
+		if (VolleysFired < NumVolleys && Now - PhaseStartTime >= VolleysFired * VolleyInterval)
+		{
+			FireVolley();
+		}
+		if (VolleysFired >= NumVolleys)
+		{
+			Phase = EPhase::Settle;
+			PhaseStartTime = Now;
+		}
+		break;
+	case EPhase::Settle:
+		if (Now - PhaseStartTime >= SettleSeconds)
+		{
+			Finish();
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+/* Targets and points only depend on Seed and the pane grid, so runs are comparable */
+void AGlassStressHarness::FireVolley()
+{
+	VolleysFired++;
+	if (Panes.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 k = 0; k < HitsPerVolley; ++k)
+	{
+		AShatterableGlass* Pane = Panes[Stream.RandHelper(Panes.Num())];
+		const float U = Stream.FRandRange(-0.8f, 0.8f);
+		const float V = Stream.FRandRange(-0.8f, 0.8f);
+		if (!IsValid(Pane))
+		{
+			continue;
+		}
+
+		FVector Origin;
+		FVector Extent;
+		Pane->GetActorBounds(true, Origin, Extent);
+		// Panes lie in their local X/Z plane
+		Pane->ApplyImpact(Origin + Pane->GetActorForwardVector() * (U * Extent.X) + Pane->GetActorUpVector() * (V * Extent.Z));
+		HitsFired++;
+	}
+}
+
+void AGlassStressHarness::RecordFrame(double Now)
+{
+	FrameMs.Add(float((Now - LastFrameTime) * 1000.0));
+	GameThreadMs.Add(float(FPlatformTime::ToMilliseconds(GGameThreadTime)));
+	PhysicsMs.Add(LastPhysicsMs);
+
+	if (const UGlassShardSubsystem* ShardPool = GetWorld()->GetSubsystem<UGlassShardSubsystem>())
+	{
+		const UGlassShardSubsystem::PoolStats Stats = ShardPool->GetStats();
+		PeakLiveShards = FMath::Max(PeakLiveShards, Stats.Live);
+		PeakSimulatingShards = FMath::Max(PeakSimulatingShards, Stats.Simulating);
+		PeakCachedBodies = FMath::Max(PeakCachedBodies, Stats.CachedHulls);
+	}
+}
+
+void AGlassStressHarness::OnPhysicsPreTick(FPhysScene* Scene, float DeltaTime)
+{
+	PhysicsStartTime = FPlatformTime::Seconds();
+}
+
+/* From the start of the physics frame to the game thread having its results, waits included */
+void AGlassStressHarness::OnPhysicsPostTick(FPhysScene* Scene)
+{
+	LastPhysicsMs = float((FPlatformTime::Seconds() - PhysicsStartTime) * 1000.0);
+}
+
+void AGlassStressHarness::Finish()
+{
+	Phase = EPhase::Done;
+	SetActorTickEnabled(false);
+
+	// The pool samples on a timer, take the final state too
+	if (UGlassShardSubsystem* ShardPool = GetWorld()->GetSubsystem<UGlassShardSubsystem>())
+	{
+		ShardPool->SampleWorldMemory();
+	}
+
+	FString Path = OutputFile;
+	if (Path.IsEmpty())
+	{
+		Path = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("GlassStress.json");
+	}
+
+	if (FFileHelper::SaveStringToFile(ToJson(), *Path))
+	{
+		UE_LOG(LogGlassFracture, Log, TEXT("Stress run: %d frames, frame p50 %.2f ms, p99 %.2f ms, peak %d live shards, written to %s"),
+			FrameMs.Num(), Percentile(FrameMs, 0.5f), Percentile(FrameMs, 0.99f), PeakLiveShards, *Path);
+	}
+	else
+	{
+		UE_LOG(LogGlassFracture, Error, TEXT("Could not write stress results to %s"), *Path);
+	}
+
+	FString Failure;
+	if (!CheckBudgets(Failure))
+	{
+		UE_LOG(LogGlassFracture, Error, TEXT("Stress run over budget: %s"), *Failure);
+	}
+
+	if (bQuitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+bool AGlassStressHarness::CheckBudgets(FString& OutFailure) const
+{
+	TArray<FString> Failures;
+	if (HitsFired == 0 || FrameMs.Num() == 0)
+	{
+		Failures.Add(TEXT("no hits or frames were recorded"));
+	}
+	const float FrameP99 = Percentile(FrameMs, 0.99f);
+	if (FrameBudgetMs > 0.0f && FrameP99 > FrameBudgetMs)
+	{
+		Failures.Add(FString::Printf(TEXT("frame p99 %.2f ms > %.2f ms"), FrameP99, FrameBudgetMs));
+	}
+	const float PhysicsP99 = Percentile(PhysicsMs, 0.99f);
+	if (PhysicsBudgetMs > 0.0f && PhysicsP99 > PhysicsBudgetMs)
+	{
+		Failures.Add(FString::Printf(TEXT("physics p99 %.2f ms > %.2f ms"), PhysicsP99, PhysicsBudgetMs));
+	}
+
+	OutFailure = FString::Join(Failures, TEXT(", "));
+	return Failures.Num() == 0;
+}
+
+FString AGlassStressHarness::ToJson() const
+{
+	auto Distribution = [](const TArray<float>& Samples) {
+		return FString::Printf(TEXT("{\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}"),
+			Percentile(Samples, 0.5f), Percentile(Samples, 0.9f), Percentile(Samples, 0.99f), Percentile(Samples, 1.0f));
+	};
+
+	int64 PeakMemoryBytes = 0;
+	if (const UGlassShardSubsystem* ShardPool = GetWorld()->GetSubsystem<UGlassShardSubsystem>())
+	{
+		PeakMemoryBytes = (int64)ShardPool->GetPeakWorldMemory().Total();
+	}
+
+	FString Json = TEXT("{\n");
+	Json += FString::Printf(TEXT("  \"panes\": %d,\n  \"volleys\": %d,\n  \"hits_per_volley\": %d,\n  \"hits\": %d,\n  \"seed\": %d,\n  \"frames\": %d,\n"),
+		Panes.Num(), NumVolleys, HitsPerVolley, HitsFired, Seed, FrameMs.Num());
+	Json += FString::Printf(TEXT("  \"game_thread_ms\": %s,\n"), *Distribution(GameThreadMs));
+	Json += FString::Printf(TEXT("  \"physics_ms\": %s,\n"), *Distribution(PhysicsMs));
+	Json += FString::Printf(TEXT("  \"frame_ms\": %s,\n"), *Distribution(FrameMs));
+	Json += FString::Printf(TEXT("  \"peak_live_shards\": %d,\n  \"peak_simulating_shards\": %d,\n  \"peak_cached_bodies\": %d,\n  \"peak_memory_bytes\": %lld,\n"),
+		PeakLiveShards, PeakSimulatingShards, PeakCachedBodies, PeakMemoryBytes);
+	FString Failure;
+	const bool bPassed = CheckBudgets(Failure);
+	Json += FString::Printf(TEXT("  \"frame_budget_ms\": %.3f,\n  \"physics_budget_ms\": %.3f,\n  \"passed\": %s\n"),
+		FrameBudgetMs, PhysicsBudgetMs, bPassed ? TEXT("true") : TEXT("false"));
+	Json += TEXT("}\n");
+	return Json;
+}
+
+/* Nearest-rank percentile; Fraction 1 is the maximum */
+float AGlassStressHarness::Percentile(const TArray<float>& Samples, float Fraction)
+{
+	if (Samples.Num() == 0)
+	{
+		return 0.0f;
+	}
+	TArray<float> Sorted = Samples;
+	Sorted.Sort();
+	const int32 Rank = FMath::Clamp(FMath::CeilToInt32(Fraction * Sorted.Num()) - 1, 0, Sorted.Num() - 1);
+	return Sorted[Rank];
+}
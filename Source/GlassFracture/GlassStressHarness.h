@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Physics/PhysicsInterfaceDeclares.h"
+#include "GlassStressHarness.generated.h"
+
+class AShatterableGlass;
+
+/**
+ * Spawns a grid of panes, hits them in scripted volleys at seeded points and records every frame until the shards settle.
+ * Game thread, physics and whole-frame percentiles plus peak shard and body counts are written as JSON, then the game exits.
+ * The automation test GlassFracture.Stress.MassDestruction runs the same harness and fails when a p99 budget is exceeded.
+ *
+ * UnrealEditor-Cmd <Project>.uproject <Map> -game -nullrhi -unattended
+ *     -ExecCmds="glass.Stress.Run Panes=100 Volleys=10 Hits=10 Seed=1 Class=/Game/Glass/BP_Glass.BP_Glass_C"
+ * UnrealEditor-Cmd <Project>.uproject -game -nullrhi -unattended -ExecCmds="Automation RunTests GlassFracture.Stress; Quit"
+ */
+UCLASS()
+class GLASSFRACTURE_API AGlassStressHarness : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	AGlassStressHarness();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void Tick(float DeltaTime) override;
+
+	void StartRun();
+	bool IsDone() const { return Phase == EPhase::Done; }
+
+	/* True when every enabled p99 budget holds; otherwise OutFailure says which did not */
+	bool CheckBudgets(FString& OutFailure) const;
+
+	// Set up with a pattern and layout; the plain class has no pattern and only exercises the Voronoi path
+	UPROPERTY(EditAnywhere, Category = "Stress")	TSubclassOf<AShatterableGlass> PaneClass;
+	UPROPERTY(EditAnywhere, Category = "Stress", meta = (ClampMin = "1"))	int32 NumPanes = 100;
+	UPROPERTY(EditAnywhere, Category = "Stress")	float PaneSpacing = 400.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Stress", meta = (ClampMin = "1"))	int32 NumVolleys = 10;
+	UPROPERTY(EditAnywhere, Category = "Stress", meta = (ClampMin = "1"))	int32 HitsPerVolley = 10;
+	UPROPERTY(EditAnywhere, Category = "Stress")	float VolleyInterval = 0.5f;
+	UPROPERTY(EditAnywhere, Category = "Stress")	int32 Seed = 1;
+
+	// Frames before the first volley are not recorded, frames after the last one are for SettleSeconds
+	UPROPERTY(EditAnywhere, Category = "Stress")	float WarmupSeconds = 2.0f;
+	UPROPERTY(EditAnywhere, Category = "Stress")	float SettleSeconds = 5.0f;
+
+	// 99th percentile limits over the recorded frames, 0 disables
+	UPROPERTY(EditAnywhere, Category = "Stress", meta = (ClampMin = "0.0"))	float FrameBudgetMs = 33.3f;
+	UPROPERTY(EditAnywhere, Category = "Stress", meta = (ClampMin = "0.0"))	float PhysicsBudgetMs = 16.7f;
+
+	// Defaults to Saved/Benchmarks/GlassStress.json
+	UPROPERTY(EditAnywhere, Category = "Stress")	FString OutputFile;
+	UPROPERTY(EditAnywhere, Category = "Stress")	bool bRunOnBeginPlay = false;
+	UPROPERTY(EditAnywhere, Category = "Stress")	bool bQuitWhenDone = true;
+
+private:
+	enum class EPhase : uint8
+	{
+		Idle,
+		Warmup,
+		Volleys,
+		Settle,
+		Done
+	};
+
+	UPROPERTY(Transient)	TArray<AShatterableGlass*> Panes;
+
+	FDelegateHandle PhysicsPreTickHandle;
+	FDelegateHandle PhysicsPostTickHandle;
+	FRandomStream Stream;
+	EPhase Phase = EPhase::Idle;
+	double PhaseStartTime = 0.0;
+	double LastFrameTime = 0.0;
+	double PhysicsStartTime = 0.0;
+	float LastPhysicsMs = 0.0f;
+	int32 VolleysFired = 0;
+	int32 HitsFired = 0;
+
+	TArray<float> GameThreadMs;
+	TArray<float> PhysicsMs;
+	TArray<float> FrameMs;
+	int32 PeakLiveShards = 0;
+	int32 PeakSimulatingShards = 0;
+	int32 PeakCachedBodies = 0;
+
+	void SpawnPanes();
+	void FireVolley();
+	void RecordFrame(double Now);
+	void OnPhysicsPreTick(FPhysScene* Scene, float DeltaTime);
+	void OnPhysicsPostTick(FPhysScene* Scene);
+	void Finish();
+
+	FString ToJson() const;
+	static float Percentile(const TArray<float>& Samples, float Fraction);
+};
@@ -0,0 +1,190 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FracturePatternAsset.h"
+#include "PolygonData.h"
+#include "VertexData.h"
+#include "GlassFracture/ConvexDecomposition.h"
+#include "GlassFracture/GlassFracture.h"
+#include "Hash/CityHash.h"
+
+void UFracturePatternAsset::PostLoad()
+{
+    Super::PostLoad();
+
+    // Assets compiled before cells were decomposed only carry the raw cells
+    if (NumCells() > 0 && NumParts() == 0)
+    {
+        BuildConvexParts();
+    }
+}
+
+bool UFracturePatternAsset::BuildFromDataTables(const UDataTable* InPolygonDataTable, const UDataTable* InVertexDataTable)
+{
+    LLM_SCOPE_BYTAG(GlassFracture);
+    CellVertices.Reset();
+    CellOffsets.Reset();
+    CellBounds.Reset();
+    PatternBounds = FBox2D(ForceInit);
+
+    if (!InPolygonDataTable || !InVertexDataTable)
+    {
+        UE_LOG(LogGlassFracture, Warning, TEXT("Invalid DataTable(s) provided."));
+        return false;
+    }
+
+    // Resolve every vertex row once instead of one FName lookup per polygon corner
+    TMap<int32, FVector2D> ScaledVertices;
+    ScaledVertices.Reserve(InVertexDataTable->GetRowMap().Num());
+    for (const TPair<FName, uint8*>& Row : InVertexDataTable->GetRowMap())
+    {
+        const FVertexData* VertexRow = reinterpret_cast<const FVertexData*>(Row.Value);
+        int32 Index = FCString::Atoi(*Row.Key.ToString());
+        ScaledVertices.Add(Index, FVector2D(VertexRow->X * ScaleFactor, VertexRow->Y * ScaleFactor));
+    }
+
+    const FVector2D* CenterPoint = ScaledVertices.Find(ReferenceVertex);
+    if (!CenterPoint)
+    {
+        UE_LOG(LogGlassFracture, Warning, TEXT("Reference Index: %d not found in VertexDataTable"), ReferenceVertex);
+        return false;
+    }
+    ReferencePoint = *CenterPoint;
+
+    TArray<FPolygonData*> PolygonRows;
+    InPolygonDataTable->GetAllRows<FPolygonData>(TEXT(""), PolygonRows);
+
+    CellOffsets.Reserve(PolygonRows.Num() + 1);
+    CellBounds.Reserve(PolygonRows.Num());
+    CellOffsets.Add(0);
+
+    for (const FPolygonData* PolygonRow : PolygonRows)
+    {
+        if (!PolygonRow)
+        {
+            continue;
+        }
+
+        // Rows list a closed loop; walk it backwards and drop the repeated vertex
+        TArray<int32> VertexIndices = ConvertStringToIntArray(PolygonRow->VertexIndices);
+        FBox2D Bounds(ForceInit);
+
+        for (int32 idx = VertexIndices.Num() - 1; idx > 0; idx--)
+        {
+            const FVector2D* Vertex = ScaledVertices.Find(VertexIndices[idx]);
+            if (Vertex)
+            {
+                FVector2D Relative = *Vertex - ReferencePoint;
+                CellVertices.Add(FVector2f(Relative));
+                Bounds += Relative;
+            }
+            else
+            {
+                UE_LOG(LogGlassFracture, Warning, TEXT("Vertex Index: %d not found in VertexDataTable"), VertexIndices[idx]);
+            }
+        }
+
+        CellOffsets.Add(CellVertices.Num());
+        CellBounds.Add(Bounds);
+        PatternBounds += Bounds;
+    }
+
+    BuildConvexParts();
+    return true;
+}
+
+/* Splits every cell into convex parts, emitted clockwise whatever the source winding */
+void UFracturePatternAsset::BuildConvexParts()
+{
+    LLM_SCOPE_BYTAG(GlassFracture);
+    PartVertices.Reset();
+    PartOffsets.Reset();
+    PartCells.Reset();
+    PartOffsets.Add(0);
+
+    TArray<FVector2D> Cell;
+    TArray<TArray<int32>> Parts;
+    int32 NumConcave = 0;
+
+    for (int32 c = 0; c < NumCells(); c++)
+    {
+        const int32 Begin = CellOffsets[c];
+        const int32 End = CellOffsets[c + 1];
+
+        Cell.Reset(End - Begin);
+        for (int32 v = Begin; v < End; v++)
+        {
+            Cell.Add(FVector2D(CellVertices[v]));
+        }
+
+        ConvexDecomposition::Decompose(Cell, Parts);
+        NumConcave += (Parts.Num() > 1) ? 1 : 0;
+
+        for (const TArray<int32>& Part : Parts)
+        {
+            for (int32 k = Part.Num() - 1; k >= 0; k--)
+            {
+                PartVertices.Add(CellVertices[Begin + Part[k]]);
+            }
+            PartOffsets.Add(PartVertices.Num());
+            PartCells.Add(c);
+        }
+    }
+
+    UE_LOG(LogGlassFracture, Log, TEXT("Fracture pattern: %d cells, %d concave, %d convex parts"), NumCells(), NumConcave, NumParts());
+}
+
+uint64 UFracturePatternAsset::GetContentHash() const
+{
+    uint64 Hash = CityHash64((const char*)&ReferencePoint, sizeof(ReferencePoint));
+    Hash = CityHash64WithSeed((const char*)CellVertices.GetData(), CellVertices.Num() * CellVertices.GetTypeSize(), Hash);
+    Hash = CityHash64WithSeed((const char*)CellOffsets.GetData(), CellOffsets.Num() * CellOffsets.GetTypeSize(), Hash);
+    Hash = CityHash64WithSeed((const char*)PartVertices.GetData(), PartVertices.Num() * PartVertices.GetTypeSize(), Hash);
+    Hash = CityHash64WithSeed((const char*)PartOffsets.GetData(), PartOffsets.Num() * PartOffsets.GetTypeSize(), Hash);
+    return CityHash64WithSeed((const char*)PartCells.GetData(), PartCells.Num() * PartCells.GetTypeSize(), Hash);
+}
+
+UFracturePatternAsset* UFracturePatternAsset::GetOrBuildTransient(const UDataTable* InPolygonDataTable, const UDataTable* InVertexDataTable)
+{
+    using FTableKey = TPair<const UDataTable*, const UDataTable*>;
+    static TMap<FTableKey, TWeakObjectPtr<UFracturePatternAsset>> TransientPatterns;
+
+    check(IsInGameThread());
+
+    const FTableKey Key(InPolygonDataTable, InVertexDataTable);
+    if (UFracturePatternAsset* Existing = TransientPatterns.FindRef(Key).Get())
+    {
+        return Existing;
+    }
+
+    UFracturePatternAsset* Pattern = NewObject<UFracturePatternAsset>(GetTransientPackage());
+    Pattern->BuildFromDataTables(InPolygonDataTable, InVertexDataTable);
+    TransientPatterns.Add(Key, Pattern);
+
+    return Pattern;
+}
+
+#if WITH_EDITOR
+void UFracturePatternAsset::Rebuild()
+{
+    if (BuildFromDataTables(PolygonDataTable, VertexDataTable))
+    {
+        MarkPackageDirty();
+    }
+}
+#endif
+
+TArray<int32> UFracturePatternAsset::ConvertStringToIntArray(const FString& StringData)
+{
+    TArray<int32> ResultArray;
+    TArray<FString> SplitStrings;
+    StringData.ParseIntoArray(SplitStrings, TEXT(","), true);
+
+    for (const FString& NumberStr : SplitStrings)
+    {
+        int32 Number = FCString::Atoi(*NumberStr);
+        ResultArray.Add(Number);
+    }
+
+    return ResultArray;
+}
@@ -0,0 +1,86 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "Engine/DataTable.h"
+#include "FracturePatternAsset.generated.h"
+
+/**
+ * Pre-parsed spiderweb pattern compiled from DT_polygons / DT_vertices.
+ * Cell vertices are stored flat, already scaled and relative to the reference point, in the winding used for clipping.
+ * Concave cells are split into convex parts when the pattern is compiled, so a hit only ever clips against convex polygons.
+ */
+UCLASS(BlueprintType)
+class GLASSFRACTURE_API UFracturePatternAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category = "Source")
+	float ScaleFactor = 0.22f;
+
+	UPROPERTY(EditAnywhere, Category = "Source")
+	int32 ReferenceVertex = 366;
+
+#if WITH_EDITORONLY_DATA
+	UPROPERTY(EditAnywhere, Category = "Source")
+	UDataTable* PolygonDataTable = nullptr;
+
+	UPROPERTY(EditAnywhere, Category = "Source")
+	UDataTable* VertexDataTable = nullptr;
+#endif
+
+	// Cell c owns CellVertices[CellOffsets[c] .. CellOffsets[c + 1])
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	TArray<FVector2f> CellVertices;
+
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	TArray<int32> CellOffsets;
+
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	TArray<FBox2D> CellBounds;
+
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	FBox2D PatternBounds = FBox2D(ForceInit);
+
+	// Scaled position of the reference vertex in the source tables
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	FVector2D ReferencePoint = FVector2D::ZeroVector;
+
+	// Convex clip polygons, clockwise. Part p owns PartVertices[PartOffsets[p] .. PartOffsets[p + 1]) and was cut from cell PartCells[p]
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	TArray<FVector2f> PartVertices;
+
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	TArray<int32> PartOffsets;
+
+	UPROPERTY(VisibleAnywhere, Category = "Compiled")
+	TArray<int32> PartCells;
+
+	int32 NumCells() const { return FMath::Max(CellOffsets.Num() - 1, 0); }
+	int32 NumParts() const { return FMath::Max(PartOffsets.Num() - 1, 0); }
+	bool IsCompiled() const { return NumParts() > 0; }
+
+	/* Hash of the compiled cells and parts, for caches that must not outlive an edit or reimport */
+	uint64 GetContentHash() const;
+
+	virtual void PostLoad() override;
+
+	bool BuildFromDataTables(const UDataTable* InPolygonDataTable, const UDataTable* InVertexDataTable);
+
+	/* Rebuilds the convex parts from CellVertices / CellOffsets */
+	void BuildConvexParts();
+
+	/* Transient pattern compiled from the given tables, shared by every caller passing the same pair */
+	static UFracturePatternAsset* GetOrBuildTransient(const UDataTable* InPolygonDataTable, const UDataTable* InVertexDataTable);
+
+#if WITH_EDITOR
+	UFUNCTION(CallInEditor, Category = "Source")
+	void Rebuild();
+#endif
+
+private:
+	static TArray<int32> ConvertStringToIntArray(const FString& StringData);
+};
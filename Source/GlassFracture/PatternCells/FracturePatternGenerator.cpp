@@ -2,69 +2,39 @@
 
 
 #include "FracturePatternGenerator.h"
-#include "PolygonData.h"
-#include "VertexData.h"
-#include "Algo/Reverse.h"
+#include "FracturePatternAsset.h"
+#include "GlassFracture/GlassFracture.h"
 
-TArray<Piece> FracturePatternGenerator::CreateSpiderwebPieces(const FVector& ImpactLocation, const FVector& ActorLocation, const UDataTable* PolygonDataTable, const UDataTable* VertexDataTable)
+/* Instantiates the convex parts of the compiled pattern around the impact; only an offset is applied per vertex */
+TArray<Piece> FracturePatternGenerator::CreateSpiderwebPieces(const FVector& ImpactLocation, const UFracturePatternAsset* Pattern)
 {
     TArray<Piece> Pieces;
 
-    if (!PolygonDataTable || !VertexDataTable)
+    if (!Pattern || !Pattern->IsCompiled())
     {
-        UE_LOG(LogTemp, Warning, TEXT("Invalid DataTable(s) provided."));
+        UE_LOG(LogGlassFracture, Warning, TEXT("Invalid fracture pattern provided."));
         return Pieces;
     }
 
-    FString CenterPointIdx = FString::FromInt(366);
-    FVertexData* CenterPoint = VertexDataTable->FindRow<FVertexData>(FName(*CenterPointIdx), TEXT("" ));
+    const float OffsetX = ImpactLocation.X;
+    const float OffsetZ = ImpactLocation.Z;
+    const int32 NumParts = Pattern->NumParts();
+    Pieces.Reserve(NumParts);
 
-    if (!CenterPoint)
+    TArray<Point> Points;
+    for (int32 Part = 0; Part < NumParts; Part++)
     {
-        UE_LOG(LogTemp, Warning, TEXT("Reference Index: %d not found in VertexDataTable"), 366);
-        return Pieces;
-    }
-
-    const float ScaleFactor = 0.22f;
-    FVector ReferenceLocation(CenterPoint->X * ScaleFactor, 0.0f, CenterPoint->Y * ScaleFactor);
-    FVector Offset = ImpactLocation - ReferenceLocation;
-
-    TArray<FPolygonData*> PolygonRows;
-    PolygonDataTable->GetAllRows<FPolygonData>(TEXT(""), PolygonRows);
+        const int32 Begin = Pattern->PartOffsets[Part];
+        const int32 End = Pattern->PartOffsets[Part + 1];
 
-    for (int32 i = 0; i < PolygonRows.Num(); i++)
-    {
-        FPolygonData* PolygonRow = PolygonRows[i];
-        if (PolygonRow)
+        Points.Reset(End - Begin);
+        for (int32 v = Begin; v < End; v++)
         {
-            TArray<int32> VertexIndices = ConvertStringToIntArray(PolygonRow->VertexIndices);
-            Algo::Reverse(VertexIndices);
-
-            TArray<Point> Points;
-            TArray<Edge> Edges;
-
-            for (int32 idx = 0; idx < VertexIndices.Num() - 1; idx++)
-            {
-                int32 Index = VertexIndices[idx];
-                FString RowName = FString::FromInt(Index);
-                FVertexData* VertexRow = VertexDataTable->FindRow<FVertexData>(FName(*RowName), TEXT(""));
-
-                if (VertexRow)
-                {
-                    float ScaledX = VertexRow->X * ScaleFactor;
-                    float ScaledY = VertexRow->Y * ScaleFactor;
-
-                    FVector VertexPosition = FVector(ScaledX, 0.0f, ScaledY) + Offset;
-                    Points.Add(Point(VertexPosition.X, VertexPosition.Z));
-                }
-                else
-                {
-                    UE_LOG(LogTemp, Warning, TEXT("Vertex Index: %d not found in VertexDataTable"), Index);
-                }
-            }
-
-            Pieces.Add(Piece(Points));
+            const FVector2f& Vertex = Pattern->PartVertices[v];
+            Points.Emplace(Vertex.X + OffsetX, Vertex.Y + OffsetZ);
         }
+
+        Pieces.Add(Piece(Points));
     }
 
     return Pieces;
@@ -77,26 +47,11 @@ UDataTable* FracturePatternGenerator::LoadFracturePatternDataTable(const FString
     {
         return DataTable.Object;
     }
-    UE_LOG(LogTemp, Error, TEXT("Failed to load DataTable at path: %s"), *DataTablePath);
+    UE_LOG(LogGlassFracture, Error, TEXT("Failed to load DataTable at path: %s"), *DataTablePath);
 
     return nullptr;
 }
 
-TArray<int32> FracturePatternGenerator::ConvertStringToIntArray(const FString& StringData)
-{
-    TArray<int32> ResultArray;
-    TArray<FString> SplitStrings;
-    StringData.ParseIntoArray(SplitStrings, TEXT(","), true);
-
-    for (const FString& NumberStr : SplitStrings)
-    {
-        int32 Number = FCString::Atoi(*NumberStr);
-        ResultArray.Add(Number);
-    }
-
-    return ResultArray;
-}
-
 TArray<Piece> FracturePatternGenerator::CreateDiagonalPieces(const FVector& ImpactLocation, const FVector& HalfSize, const FVector& ActorLocation)
 {
     TArray<Piece> Pieces;
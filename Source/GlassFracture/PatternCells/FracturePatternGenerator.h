@@ -6,17 +6,17 @@
 #include "GlassFracture/TriangulationTypes.h"
 #include "Engine/DataTable.h"
 
+class UFracturePatternAsset;
+
 /**
  * 
  */
 class GLASSFRACTURE_API FracturePatternGenerator
 {
 public:
-	static TArray<Piece> CreateSpiderwebPieces(const FVector& ImpactLocation, const FVector& ActorLocation,
-			const UDataTable* PolygonDataTable, const UDataTable* VertexDataTable);
+	static TArray<Piece> CreateSpiderwebPieces(const FVector& ImpactLocation, const UFracturePatternAsset* Pattern);
 	static TArray<Piece> CreateDiagonalPieces(const FVector& ImpactLocation, const FVector& HalfSize, const FVector& ActorLocation);
 
 private:
 	static UDataTable* LoadFracturePatternDataTable(const FString& DataTablePath);
-	static TArray<int32> ConvertStringToIntArray(const FString& StringData);
 };
@@ -0,0 +1,110 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PieceGrid.h"
+
+void PieceGrid::Build(const TArray<Piece>& Pieces)
+{
+	const int32 MaxCellsPerAxis = 256;
+
+	PieceBounds.Reset(Pieces.Num());
+	CellStart.Reset();
+	Entries.Reset();
+	NumX = NumZ = 0;
+
+	FBox2D GridBounds(ForceInit);
+	double TotalArea = 0.0;
+	for (const Piece& Piece : Pieces) {
+		PieceBounds.Add(Piece.bounds);
+		if (Piece.bounds.bIsValid) {
+			GridBounds += Piece.bounds;
+			TotalArea += Piece.bounds.GetArea();
+		}
+	}
+
+	if (!GridBounds.bIsValid) {
+		return;
+	}
+
+	// Roughly one piece per cell
+	const FVector2D Extent = GridBounds.GetSize();
+	CellSize = FMath::Max(FMath::Sqrt(TotalArea / Pieces.Num()), (double)KINDA_SMALL_NUMBER);
+	CellSize = FMath::Max(CellSize, FMath::Max(Extent.X, Extent.Y) / MaxCellsPerAxis);
+
+	Origin = GridBounds.Min;
+	NumX = FMath::Clamp(FMath::FloorToInt32(Extent.X / CellSize) + 1, 1, MaxCellsPerAxis);
+	NumZ = FMath::Clamp(FMath::FloorToInt32(Extent.Y / CellSize) + 1, 1, MaxCellsPerAxis);
+
+	// Counting pass, then fill
+	CellStart.SetNumZeroed(NumX * NumZ + 1);
+	for (const FBox2D& Box : PieceBounds) {
+		if (!Box.bIsValid) {
+			continue;
+		}
+		for (int32 z = ToCellZ(Box.Min.Y); z <= ToCellZ(Box.Max.Y); ++z) {
+			for (int32 x = ToCellX(Box.Min.X); x <= ToCellX(Box.Max.X); ++x) {
+				CellStart[z * NumX + x + 1]++;
+			}
+		}
+	}
+	for (int32 c = 0; c < NumX * NumZ; ++c) {
+		CellStart[c + 1] += CellStart[c];
+	}
+
+	TArray<int32> Cursor(CellStart.GetData(), NumX * NumZ);
+	Entries.SetNumUninitialized(CellStart.Last());
+	for (int32 i = 0; i < PieceBounds.Num(); ++i) {
+		const FBox2D& Box = PieceBounds[i];
+		if (!Box.bIsValid) {
+			continue;
+		}
+		for (int32 z = ToCellZ(Box.Min.Y); z <= ToCellZ(Box.Max.Y); ++z) {
+			for (int32 x = ToCellX(Box.Min.X); x <= ToCellX(Box.Max.X); ++x) {
+				Entries[Cursor[z * NumX + x]++] = i;
+			}
+		}
+	}
+}
+
+void PieceGrid::Query(const FBox2D& Bounds, TArray<int32>& OutIndices) const
+{
+	OutIndices.Reset();
+
+	if (NumX == 0 || !Bounds.bIsValid) {
+		return;
+	}
+
+	const int32 MinX = ToCellX(Bounds.Min.X);
+	const int32 MinZ = ToCellZ(Bounds.Min.Y);
+
+	for (int32 z = MinZ; z <= ToCellZ(Bounds.Max.Y); ++z) {
+		for (int32 x = MinX; x <= ToCellX(Bounds.Max.X); ++x) {
+			const int32 Cell = z * NumX + x;
+
+			for (int32 e = CellStart[Cell]; e < CellStart[Cell + 1]; ++e) {
+				const int32 Index = Entries[e];
+				const FBox2D& Box = PieceBounds[Index];
+
+				// Report each pair only from the first cell both boxes share
+				if (x != FMath::Max(MinX, ToCellX(Box.Min.X)) || z != FMath::Max(MinZ, ToCellZ(Box.Min.Y))) {
+					continue;
+				}
+				if (Box.Intersect(Bounds)) {
+					OutIndices.Add(Index);
+				}
+			}
+		}
+	}
+
+	OutIndices.Sort();
+}
+
+int32 PieceGrid::ToCellX(double X) const
+{
+	return FMath::Clamp(FMath::FloorToInt32((X - Origin.X) / CellSize), 0, NumX - 1);
+}
+
+int32 PieceGrid::ToCellZ(double Z) const
+{
+	return FMath::Clamp(FMath::FloorToInt32((Z - Origin.Y) / CellSize), 0, NumZ - 1);
+}
@@ -0,0 +1,31 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TriangulationTypes.h"
+
+/**
+ * PieceGrid is a uniform grid over the bounds of a set of pieces, used as the broad phase for polygon clipping.
+ */
+class GLASSFRACTURE_API PieceGrid
+{
+public:
+	void Build(const TArray<Piece>& Pieces);
+
+	/* Indices of the pieces whose bounds overlap Bounds, in ascending order */
+	void Query(const FBox2D& Bounds, TArray<int32>& OutIndices) const;
+
+private:
+	FVector2D Origin = FVector2D::ZeroVector;
+	double CellSize = 1.0;
+	int32 NumX = 0;
+	int32 NumZ = 0;
+
+	TArray<FBox2D> PieceBounds;
+	TArray<int32> CellStart;	// Entries of cell c are Entries[CellStart[c] .. CellStart[c + 1])
+	TArray<int32> Entries;
+
+	int32 ToCellX(double X) const;
+	int32 ToCellZ(double Z) const;
+};
@@ -2,67 +2,195 @@
 
 
 #include "PolygonClipper.h"
+#include "GeometricPredicates.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	// Bound on the rounding error of the float side value, relative to |dx * (z - sz)| + |dz * (x - sx)|
+	constexpr float SideErrorBound = 4.0f * FLT_EPSILON;
+}
 
-/* Sutherland-Hodgman Polygon Clipping Algorithm */
 TArray<Point> PolygonClipper::PerformClipping(const TArray<Point>& SubjectPolygon, const TArray<Point>& ClipPolygon)
 {
-	TArray<Point> outputPolygon = SubjectPolygon;
+	ClipScratch Scratch;
+	return TArray<Point>(ClipConvex(SubjectPolygon, ClipPolygon, Scratch));
+}
 
-	for (int i = 0; i < ClipPolygon.Num(); ++i) {
-		Point clipEdgeStart = ClipPolygon[i];
-		Point clipEdgeEnd = ClipPolygon[(i + 1) % ClipPolygon.Num()];
+TArrayView<const Point> PolygonClipper::ClipConvex(TArrayView<const Point> SubjectPolygon, TArrayView<const Point> ClipPolygon, ClipScratch& Scratch)
+{
+	int32 Buffer = ClipToScratch(SubjectPolygon, ClipPolygon, Scratch);
+	int32 Num = Scratch.X[Buffer].Num();
 
-		TArray<Point> inputPolygon = outputPolygon;
-		outputPolygon.Empty();
+	Scratch.Result.Reset();
+	for (int32 i = 0; i < Num; ++i) {
+		Scratch.Result.Emplace(Scratch.X[Buffer][i], Scratch.Z[Buffer][i]);
+	}
+	return Scratch.Result;
+}
 
-		for (int32 j = 0; j < inputPolygon.Num(); ++j) {
-			Point currPoint = inputPolygon[j];
-			Point prevPoint = inputPolygon[(j - 1 + inputPolygon.Num()) % inputPolygon.Num()];
+void PolygonClipper::ClipAgainstCells(TArrayView<const Point> SubjectPolygon, const TArray<Piece>& Cells, TArrayView<const int32> CellIndices, ClipBatch& OutBatch)
+{
+	OutBatch.Points.Reset();
+	OutBatch.Offsets.Reset();
+	OutBatch.CellIndices.Reset();
+	OutBatch.Offsets.Add(0);
 
-			bool currInside = IsInside(currPoint, clipEdgeStart, clipEdgeEnd);
-			bool prevInside = IsInside(prevPoint, clipEdgeStart, clipEdgeEnd);
+	for (int32 CellIndex : CellIndices) {
+		int32 Buffer = ClipToScratch(SubjectPolygon, Cells[CellIndex].points, OutBatch.Scratch);
+		int32 Num = OutBatch.Scratch.X[Buffer].Num();
 
-			if (currInside) {
-				if (!prevInside) {
-					outputPolygon.Add(ComputeIntersection(prevPoint, currPoint, clipEdgeStart, clipEdgeEnd));
-				}
-				outputPolygon.Add(currPoint);
+		if (Num == 0) {
+			continue;
+		}
+		for (int32 i = 0; i < Num; ++i) {
+			OutBatch.Points.Emplace(OutBatch.Scratch.X[Buffer][i], OutBatch.Scratch.Z[Buffer][i]);
+		}
+		OutBatch.Offsets.Add(OutBatch.Points.Num());
+		OutBatch.CellIndices.Add(CellIndex);
+	}
+}
+
+/* Sutherland-Hodgman Polygon Clipping Algorithm, returns the scratch buffer holding the result */
+int32 PolygonClipper::ClipToScratch(TArrayView<const Point> SubjectPolygon, TArrayView<const Point> ClipPolygon, ClipScratch& Scratch)
+{
+	int32 Src = 0;
+	Scratch.X[Src].SetNumUninitialized(SubjectPolygon.Num(), false);
+	Scratch.Z[Src].SetNumUninitialized(SubjectPolygon.Num(), false);
+	for (int32 i = 0; i < SubjectPolygon.Num(); ++i) {
+		Scratch.X[Src][i] = SubjectPolygon[i].x;
+		Scratch.Z[Src][i] = SubjectPolygon[i].z;
+	}
+
+	for (int32 i = 0; i < ClipPolygon.Num(); ++i) {
+		const int32 Num = Scratch.X[Src].Num();
+		if (Num == 0) {
+			break;
+		}
+
+		const Point& clipEdgeStart = ClipPolygon[i];
+		const Point& clipEdgeEnd = ClipPolygon[(i + 1) % ClipPolygon.Num()];
+
+		// Classify every vertex once against the clip edge
+		Scratch.Side.SetNumUninitialized(Num, false);
+		ClassifyVertices(Scratch.X[Src].GetData(), Scratch.Z[Src].GetData(), Num, clipEdgeStart, clipEdgeEnd, Scratch.Side.GetData());
+
+		const int32 Dst = 1 - Src;
+		const float* InX = Scratch.X[Src].GetData();
+		const float* InZ = Scratch.Z[Src].GetData();
+		const float* Side = Scratch.Side.GetData();
+
+		// Every vertex emits at most itself and one intersection
+		Scratch.X[Dst].SetNumUninitialized(2 * Num, false);
+		Scratch.Z[Dst].SetNumUninitialized(2 * Num, false);
+		float* OutX = Scratch.X[Dst].GetData();
+		float* OutZ = Scratch.Z[Dst].GetData();
+
+		int32 OutNum = 0;
+		for (int32 j = 0, prev = Num - 1; j < Num; prev = j++) {
+			bool currInside = Side[j] <= 0.0f;
+			bool prevInside = Side[prev] <= 0.0f;
+
+			// A vertex exactly on the edge is emitted as itself, never again as an intersection
+			if (currInside != prevInside && Side[j] != 0.0f && Side[prev] != 0.0f) {
+				// Signs differ, so the denominator cannot vanish
+				float t = Side[prev] / (Side[prev] - Side[j]);
+				OutX[OutNum] = InX[prev] + t * (InX[j] - InX[prev]);
+				OutZ[OutNum] = InZ[prev] + t * (InZ[j] - InZ[prev]);
+				OutNum++;
 			}
-			else if (prevInside) {
-				outputPolygon.Add(ComputeIntersection(prevPoint, currPoint, clipEdgeStart, clipEdgeEnd));
+			if (currInside) {
+				OutX[OutNum] = InX[j];
+				OutZ[OutNum] = InZ[j];
+				OutNum++;
 			}
 		}
+
+		Scratch.X[Dst].SetNum(OutNum, false);
+		Scratch.Z[Dst].SetNum(OutNum, false);
+		Src = Dst;
 	}
-	return outputPolygon;
+
+	// Edge vertices count as inside for both cells sharing the edge, so a subject only touching a cell comes out as a sliver
+	if (IsDegenerate(Scratch.X[Src].GetData(), Scratch.Z[Src].GetData(), Scratch.X[Src].Num())) {
+		Scratch.X[Src].Reset();
+		Scratch.Z[Src].Reset();
+	}
+	return Src;
 }
 
-/* Function to check if a point is inside the clipping boundary */
-bool PolygonClipper::IsInside(const Point& point, const Point& edgeStart, const Point& edgeEnd)
+/* True when fewer than three vertices remain or all of them are exactly collinear, i.e. the polygon has zero area */
+bool PolygonClipper::IsDegenerate(const float* X, const float* Z, int32 Num)
 {
-	float crossProduct = (edgeEnd.x - edgeStart.x) * (point.z - edgeStart.z)
-						- (edgeEnd.z - edgeStart.z) * (point.x - edgeStart.x);
-	return crossProduct <= -KINDA_SMALL_NUMBER;
+	if (Num < 3) {
+		return Num > 0;
+	}
+
+	const FVector2D First(X[0], Z[0]);
+	int32 Other = 1;
+	while (Other < Num && X[Other] == X[0] && Z[Other] == Z[0]) {
+		Other++;
+	}
+	if (Other == Num) {
+		return true;
+	}
+
+	const FVector2D Second(X[Other], Z[Other]);
+	for (int32 i = Other + 1; i < Num; ++i) {
+		if (GeometricPredicates::Orient2D(First, Second, FVector2D(X[i], Z[i])) != 0.0) {
+			return false;
+		}
+	}
+	return true;
 }
 
-/* Function to find the intersection of a polygon edge with the clipping boundary */
-Point PolygonClipper::ComputeIntersection(const Point& p1, const Point& p2, const Point& e1, const Point& e2)
+/* Signed distance-like value per vertex, a vertex is inside the clipping boundary when it is <= 0 and exactly on it when 0 */
+void PolygonClipper::ClassifyVertices(const float* X, const float* Z, int32 Num, const Point& EdgeStart, const Point& EdgeEnd, float* OutSide)
 {
-	float a1 = p2.z - p1.z;
-	float b1 = p1.x - p2.x;
-	float c1 = a1 * p1.x + b1 * p1.z;
+	const float dx = EdgeEnd.x - EdgeStart.x;
+	const float dz = EdgeEnd.z - EdgeStart.z;
 
-	float a2 = e2.z - e1.z;
-	float b2 = e1.x - e2.x;
-	float c2 = a2 * e1.x + b2 * e1.z;
+	const VectorRegister4Float DX = VectorSetFloat1(dx);
+	const VectorRegister4Float DZ = VectorSetFloat1(dz);
+	const VectorRegister4Float SX = VectorSetFloat1(EdgeStart.x);
+	const VectorRegister4Float SZ = VectorSetFloat1(EdgeStart.z);
+	const VectorRegister4Float ErrorBound = VectorSetFloat1(SideErrorBound);
 
-	float det = a1 * b2 - a2 * b1;
+	int32 i = 0;
+	for (; i + 4 <= Num; i += 4) {
+		VectorRegister4Float PX = VectorSubtract(VectorLoad(X + i), SX);
+		VectorRegister4Float PZ = VectorSubtract(VectorLoad(Z + i), SZ);
+		VectorRegister4Float Left = VectorMultiply(DX, PZ);
+		VectorRegister4Float Right = VectorMultiply(DZ, PX);
+		VectorRegister4Float Cross = VectorSubtract(Left, Right);
+		VectorStore(Cross, OutSide + i);
 
-	if (FMath::Abs(det) < KINDA_SMALL_NUMBER) {
-		// Lines are nearly parallel, no intersection. Return an arbitrary point.
-		return Point(0.0f, 0.0f);
+		// Lanes whose sign the float filter cannot vouch for are redone exactly
+		VectorRegister4Float Permanent = VectorAdd(VectorAbs(Left), VectorAbs(Right));
+		int32 Uncertain = VectorMaskBits(VectorCompareLE(VectorAbs(Cross), VectorMultiply(ErrorBound, Permanent)));
+		for (int32 Lane = 0; Uncertain != 0; ++Lane, Uncertain >>= 1) {
+			if (Uncertain & 1) {
+				OutSide[i + Lane] = ExactSide(X[i + Lane], Z[i + Lane], EdgeStart, EdgeEnd);
+			}
+		}
 	}
-	float x = (b2 * c1 - b1 * c2) / det;
-	float z = (a1 * c2 - a2 * c1) / det;
+	for (; i < Num; ++i) {
+		float Left = dx * (Z[i] - EdgeStart.z);
+		float Right = dz * (X[i] - EdgeStart.x);
+		OutSide[i] = Left - Right;
+		if (FMath::Abs(OutSide[i]) <= SideErrorBound * (FMath::Abs(Left) + FMath::Abs(Right))) {
+			OutSide[i] = ExactSide(X[i], Z[i], EdgeStart, EdgeEnd);
+		}
+	}
+}
 
-	return Point(x, z);
+/* Side value with the exact sign, still usable as an interpolation weight */
+float PolygonClipper::ExactSide(float X, float Z, const Point& EdgeStart, const Point& EdgeEnd)
+{
+	double Side = GeometricPredicates::Orient2D(FVector2D(EdgeStart.x, EdgeStart.z), FVector2D(EdgeEnd.x, EdgeEnd.z), FVector2D(X, Z));
+	float Rounded = (float)Side;
+	if (Rounded == 0.0f && Side != 0.0) {
+		Rounded = (Side > 0.0) ? FLT_MIN : -FLT_MIN;
+	}
+	return Rounded;
 }
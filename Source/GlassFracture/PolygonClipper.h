@@ -7,13 +7,56 @@
 
 /**
  * PolygonClipper is a utility class for performing polygon clipping operations using the Sutherland-Hodgman algorithm.
+ * Clip polygons are expected to be convex and wound clockwise; the subject keeps its own winding.
+ * Vertices are classified with exact orientation signs, so a vertex on a clip edge is kept once and never duplicated.
+ * Results with zero area, such as a subject touching a cell only along an edge, come back empty.
  */
 class GLASSFRACTURE_API PolygonClipper
 {
 public:
+	static constexpr int32 InlineVertices = 64;
+
+	/**
+	 * Scratch storage for clipping. Vertices are kept in SoA form and ping-pong between two buffers.
+	 * A pass can double the vertex count, so only subjects of up to InlineVertices / 2 vertices stay inline;
+	 * larger ones spill to the heap once and, since the buffers never shrink, later calls on the same instance reuse that storage.
+	 */
+	struct ClipScratch
+	{
+		TArray<float, TInlineAllocator<InlineVertices>> X[2];
+		TArray<float, TInlineAllocator<InlineVertices>> Z[2];
+		TArray<float, TInlineAllocator<InlineVertices>> Side;
+		TArray<Point, TInlineAllocator<InlineVertices>> Result;
+	};
+
+	/* Polygons produced by clipping one subject against several cells, stored back to back */
+	struct ClipBatch
+	{
+		TArray<Point> Points;
+		TArray<int32> Offsets;
+		TArray<int32> CellIndices;
+		ClipScratch Scratch;
+
+		int32 Num() const { return CellIndices.Num(); }
+		TArrayView<const Point> GetPolygon(int32 Index) const
+		{
+			return TArrayView<const Point>(Points.GetData() + Offsets[Index], Offsets[Index + 1] - Offsets[Index]);
+		}
+	};
+
 	static TArray<Point> PerformClipping(const TArray<Point>& SubjectPolygon, const TArray<Point>& ClipPolygon);
 
+	/* Clips SubjectPolygon against ClipPolygon. The result lives in Scratch until the next call. */
+	static TArrayView<const Point> ClipConvex(TArrayView<const Point> SubjectPolygon, TArrayView<const Point> ClipPolygon, ClipScratch& Scratch);
+
+	/* Clips SubjectPolygon against Cells[CellIndices[k]] for every k, keeping only the non-empty results */
+	static void ClipAgainstCells(TArrayView<const Point> SubjectPolygon, const TArray<Piece>& Cells, TArrayView<const int32> CellIndices, ClipBatch& OutBatch);
+
+	/* Side of (X, Z) against the directed edge: positive on its left, negative on its right, 0 only when exactly on it */
+	static float ExactSide(float X, float Z, const Point& EdgeStart, const Point& EdgeEnd);
+
 private:
-	static bool IsInside(const Point& point, const Point& edgeStart, const Point& edgeEnd);
-	static Point ComputeIntersection(const Point& v1, const Point& v2, const Point& e1, const Point& e2);
+	static int32 ClipToScratch(TArrayView<const Point> SubjectPolygon, TArrayView<const Point> ClipPolygon, ClipScratch& Scratch);
+	static void ClassifyVertices(const float* X, const float* Z, int32 Num, const Point& EdgeStart, const Point& EdgeEnd, float* OutSide);
+	static bool IsDegenerate(const float* X, const float* Z, int32 Num);
 };
@@ -2,16 +2,52 @@
 
 
 #include "ShatterableGlass.h"
-#include "PolygonClipper.h"
-#include "PatternCells/FracturePatternGenerator.h"
+#include "GlassFracture.h"
 #include "VoronoiDiagram/VoronoiGenerator.h"
+#include "VoronoiDiagram/PoissonDiskSampler.h"
+#include "GlassShardSubsystem.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameStateBase.h"
+#include "Net/UnrealNetwork.h"
+#include "Hash/CityHash.h"
+
+namespace
+{
+	// Events older than this when they reach a client are history: the pane is rebuilt but no shards fall
+	constexpr float MaxShardReplayAge = 2.0f;
+
+	// Rounded the way FVector_NetQuantize10 is sent, so the server fractures and launches shards exactly as clients do
+	FVector QuantizeTenths(const FVector& V)
+	{
+		return FVector(FMath::RoundToDouble(V.X * 10.0) / 10.0, FMath::RoundToDouble(V.Y * 10.0) / 10.0, FMath::RoundToDouble(V.Z * 10.0) / 10.0);
+	}
+}
+
+void FGlassFractureSnapshot::Fold(const FGlassFractureEvent& Event)
+{
+	check(Event.Index == Impacts.Num());
+	Impacts.Add(FIntPoint(FMath::RoundToInt32(Event.LocalImpact.X * 10.0), FMath::RoundToInt32(Event.LocalImpact.Z * 10.0)));
+}
+
+/* The folded hit as a shardless event; the seed, impulse and time only ever mattered for shards */
+FGlassFractureEvent FGlassFractureSnapshot::Unfold(int32 Index) const
+{
+	FGlassFractureEvent Event;
+	Event.LocalImpact = FVector(Impacts[Index].X / 10.0, 0.0, Impacts[Index].Y / 10.0);
+	Event.Index = Index;
+	return Event;
+}
 
 // Sets default values
 AShatterableGlass::AShatterableGlass()
 {
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	// Only hit events replicate, see FGlassFractureEvent; intact panes stay out of the replication scan until hit
+	bReplicates = true;
+	NetDormancy = DORM_Initial;
 
 	USceneComponent* Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
 	SetRootComponent(Root);
@@ -47,6 +83,7 @@ AShatterableGlass::AShatterableGlass()
 	ProcMesh->SetCollisionObjectType(ECollisionChannel::ECC_PhysicsBody);
 
 	ProcMesh->bUseComplexAsSimpleCollision = false;
+	ProcMesh->bUseAsyncCooking = true;
 	ProcMesh->bAlwaysCreatePhysicsState = true;
 
 	ProcMesh->SetSimulatePhysics(true);
@@ -61,141 +98,459 @@ AShatterableGlass::AShatterableGlass()
 void AShatterableGlass::BeginPlay()
 {
 	Super::BeginPlay();
+	LLM_SCOPE_BYTAG(GlassFracture);
 
+	ComputeLocalBounds();
+
+	UE_LOG(LogGlassFracture, Warning, TEXT("Min Bounds: %s, Max Bounds: %s"), *LocalMinBound.ToString(), *LocalMaxBound.ToString());
+
+	ActivePattern = PatternAsset;
+	if (!ActivePattern || !ActivePattern->IsCompiled())
+	{
+		ActivePattern = UFracturePatternAsset::GetOrBuildTransient(PolygonDataTable, VertexDataTable);
+	}
+
+	/*CreateGridPolygons(4, 4);
+	VisualizePieces(GridPolygons, false, 1.0f);
+	IntactPieces = GridPolygons;*/
+
+	const FBakedPaneLayout* BakedLayout = (LayoutAsset && !bLazyPreFracture) ? LayoutAsset->FindLayout(GetPaneSize(), LayoutSeed, GetLayoutSettingsHash()) : nullptr;
+	if (bLazyPreFracture)
+	{
+		LazySiteStream.Initialize(LayoutSeed);
+		CoarsePieces.Add(FractureJob::MakeBoxPiece(GetPaneBox()));
+		IntactPieces.Reset();
+	}
+	else if (BakedLayout)
+	{
+		IntactPieces = UPaneLayoutAsset::LoadPieces(*BakedLayout, FVector2D(LocalMinBound.X, LocalMinBound.Z));
+	}
+	else
+	{
+		IntactPieces = GeneratePaneLayout();
+	}
+	VisualizePieces(IntactPieces, true, 1.0f);
+	VisualizePieces(CoarsePieces, false, 1.0f);
+	UpdatePeakMemory();
+
+	// Panes sharing these settings start from the same pieces and share cached fracture results
+	// Assets are keyed by content, so an edit, a reimport or a reused transient name never matches old results
+	const FString PaneSettings = FString::Printf(TEXT("%s|%s|%d|%d|%llu|%d|%f|%f|%d|%f|%f|%s|%d|%f|%d|%f|%f|%d|%llu"),
+		*LocalMinBound.ToString(), *LocalMaxBound.ToString(), LayoutSeed, bLazyPreFracture ? 1 : 0,
+		BakedLayout ? BakedLayout->GetContentHash() : 0ull, NumSites, SiteMinDistance, SiteEdgeOffset,
+		(int32)SiteDensity, DenseSiteSpacing, DensityFalloff, *PredictedImpact.ToString(), (int32)VoronoiBackend,
+		ImpactRadius, IntactSectionTiles, GlassThickness, ShardProxySize, MaxHullVertices, ActivePattern ? ActivePattern->GetContentHash() : 0ull);
+	PaneSettingsHash = CityHash64((const char*)*PaneSettings, PaneSettings.Len() * sizeof(TCHAR));
+	HitHistoryHash = (uint64)(uint32)LayoutSeed;
+
+	// Seeds are drawn on the server only and travel with each event
+	EventSeedStream.Initialize(HashCombine(GetTypeHash(LayoutSeed), GetTypeHash(GetFName())));
+	ApplyPendingEvents();
+}
+
+void AShatterableGlass::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AShatterableGlass, FractureEvents);
+	DOREPLIFETIME(AShatterableGlass, FractureSnapshot);
+}
+
+void AShatterableGlass::ComputeLocalBounds()
+{
 	Glass->GetLocalBounds(LocalMinBound, LocalMaxBound);
 	FVector Scale = Glass->GetComponentScale();
 	LocalMinBound *= Scale;
 	LocalMaxBound *= Scale;
+}
 
-	UE_LOG(LogTemp, Warning, TEXT("Min Bounds: %s, Max Bounds: %s"), *LocalMinBound.ToString(), *LocalMaxBound.ToString());
+/* Everything GeneratePaneLayout depends on besides the pane size and seed, which key the bake */
+uint64 AShatterableGlass::GetLayoutSettingsHash() const
+{
+	const FString Settings = FString::Printf(TEXT("%d|%f|%f|%d|%f|%f|%s|%d"),
+		NumSites, SiteMinDistance, SiteEdgeOffset, (int32)SiteDensity, DenseSiteSpacing, DensityFalloff, *PredictedImpact.ToString(), (int32)VoronoiBackend);
+	return CityHash64((const char*)*Settings, Settings.Len() * sizeof(TCHAR));
+}
 
-	/*CreateGridPolygons(4, 4);
-	VisualizePieces(GridPolygons, false, 1.0f);
-	IntactPieces = GridPolygons;*/
+/* Seeded, so a bake and the runtime fallback produce the same layout */
+TArray<Piece> AShatterableGlass::GeneratePaneLayout()
+{
+	FRandomStream Stream(LayoutSeed);
+	TArray<Point> RandomPoints = GenerateRandomPoints(Stream, GetPaneBox().ExpandBy(SiteEdgeOffset), SiteMinDistance, NumSites);
+	return VoronoiGenerator::GenerateVoronoiCells(RandomPoints, LocalMinBound, LocalMaxBound, VoronoiBackend);
+}
+
+#if WITH_EDITOR
+void AShatterableGlass::BakeLayout()
+{
+	if (!LayoutAsset || !Glass)
+	{
+		UE_LOG(LogGlassFracture, Warning, TEXT("BakeLayout needs a LayoutAsset and the glass mesh."));
+		return;
+	}
+
+	ComputeLocalBounds();
+	TArray<Piece> Pieces = GeneratePaneLayout();
 
-	TArray<Point> RandomPoints = GenerateRandomPoints(50.0f, 70, 60.0f);
-	TArray<Piece> VoronoiPolygons = VoronoiGenerator::GenerateVoronoiCells(RandomPoints, LocalMinBound, LocalMaxBound);
-	VisualizePieces(VoronoiPolygons, true, 1.0f);
-	IntactPieces = VoronoiPolygons;
+	LayoutAsset->Modify();
+	LayoutAsset->StoreLayout(GetPaneSize(), LayoutSeed, GetLayoutSettingsHash(), FVector2D(LocalMinBound.X, LocalMinBound.Z), Pieces);
+	LayoutAsset->MarkPackageDirty();
+
+	UE_LOG(LogGlassFracture, Log, TEXT("Baked %d cells for pane %s, seed %d"), Pieces.Num(), *GetPaneSize().ToString(), LayoutSeed);
+}
+#endif
+
+void AShatterableGlass::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// The job reads the pattern asset referenced by this actor
+	if (FractureTask.IsValid())
+	{
+		FractureTask.Wait();
+		FractureTask = UE::Tasks::TTask<FractureJobResult>();
+	}
+	QueuedHits.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShatterableGlass::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (FractureTask.IsValid() && FractureTask.IsCompleted())
+	{
+		FractureJobResult Result = MoveTemp(FractureTask.GetResult());
+		FractureTask = UE::Tasks::TTask<FractureJobResult>();
+		if (InFlightCacheKey.IsSet())
+		{
+			// Moved into the cache and applied from there
+			const TSharedPtr<const FractureJobResult> Shared = FractureResultCache::Get().Add(InFlightCacheKey.GetValue(), MoveTemp(Result));
+			InFlightCacheKey.Reset();
+			ApplyFracture(*Shared);
+		}
+		else
+		{
+			ApplyFracture(Result);
+		}
+
+		// Cached hits apply immediately, keep going until one needs a job
+		while (!FractureTask.IsValid() && QueuedHits.Num() > 0)
+		{
+			PendingHit NextHit = QueuedHits[0];
+			QueuedHits.RemoveAt(0);
+			LaunchFracture(NextHit);
+		}
+	}
+
+	if (!FractureTask.IsValid())
+	{
+		SetActorTickEnabled(false);
+	}
 }
 
 void AShatterableGlass::OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit)
 {
 	if (OtherActor && (OtherActor != this) && OtherComp)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("Cube hit by %s at location %s"), *OtherActor->GetName(), *Hit.ImpactPoint.ToString());
-		UE_LOG(LogTemp, Warning, TEXT("Hit! > %s component"), *HitComp->GetName());
+		UE_LOG(LogGlassFracture, Verbose, TEXT("Cube hit by %s at location %s"), *OtherActor->GetName(), *Hit.ImpactPoint.ToString());
+		UE_LOG(LogGlassFracture, Verbose, TEXT("Hit! > %s component"), *HitComp->GetName());
 
-		FVector WorldHitLocation = Hit.ImpactPoint;
-		FVector LocalHitPosition = HitComp->GetComponentTransform().InverseTransformPosition(WorldHitLocation);
-		UE_LOG(LogTemp, Warning, TEXT("Hit Point in Glass Local Space: %s"), *LocalHitPosition.ToString());
-		UE_LOG(LogTemp, Warning, TEXT("Hit Point in World Space: %s"), *WorldHitLocation.ToString());
-		UE_LOG(LogTemp, Warning, TEXT("Actor Location: %s"), *GetActorLocation().ToString());
+		HandleImpact(HitComp, Hit.ImpactPoint);
+	}
+}
 
-		DrawDebugSphere(GetWorld(), WorldHitLocation, 8.0f, 12, FColor::White, false, 0.0f);
-		float ImpactRadius = 80.0f;
-		DrawImpactCircle(WorldHitLocation, ImpactRadius, 0.0f);
+void AShatterableGlass::ApplyImpact(const FVector& WorldHitLocation)
+{
+	UPrimitiveComponent* HitComp = Glass ? (UPrimitiveComponent*)Glass : ProcMesh;
+	if (HitComp)
+	{
+		HandleImpact(HitComp, WorldHitLocation);
+	}
+}
 
-		//PatternCells = FracturePatternGenerator::CreateDiagonalPieces(WorldHitLocation, LocalMaxBound - LocalMinBound, GetActorLocation());
-		if (HitComp == Glass)
-			PatternCells = FracturePatternGenerator::CreateSpiderwebPieces(LocalHitPosition * 3.0f, GetActorLocation(), PolygonDataTable, VertexDataTable);
-		else if (HitComp == ProcMesh)
-			PatternCells = FracturePatternGenerator::CreateSpiderwebPieces(LocalHitPosition, GetActorLocation(), PolygonDataTable, VertexDataTable);
-		VisualizePieces(PatternCells, false, 0.0f);
+void AShatterableGlass::HandleImpact(UPrimitiveComponent* HitComp, const FVector& WorldHitLocation)
+{
+	// Clients fracture when the server's event arrives
+	if (!HasAuthority())
+	{
+		return;
+	}
+	if (FractureTask.IsValid() && QueuedHits.Num() >= MaxQueuedHits)
+	{
+		return;
+	}
+	const int32 HistoryCap = MaxFoldedImpacts + MaxFractureEvents;
+	if (FractureSnapshot.Impacts.Num() + FractureEvents.Num() >= HistoryCap)
+	{
+		return;
+	}
 
-		TArray<Piece> ClippedPieces;
-		TArray<Piece> OutsidePieces;
-		TMap<int32, TArray<int32>> CellToPiecesMap;
+	FVector LocalHitPosition = HitComp->GetComponentTransform().InverseTransformPosition(WorldHitLocation);
+	UE_LOG(LogGlassFracture, Verbose, TEXT("Hit Point in Glass Local Space: %s"), *LocalHitPosition.ToString());
+	UE_LOG(LogGlassFracture, Verbose, TEXT("Hit Point in World Space: %s"), *WorldHitLocation.ToString());
+	UE_LOG(LogGlassFracture, Verbose, TEXT("Actor Location: %s"), *GetActorLocation().ToString());
 
-		int32 PieceIndex = 0;
-		for (int32 i = 0; i < IntactPieces.Num(); ++i) {
-			const Piece& Subject = IntactPieces[i];
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
 
-			FVector Scale = HitComp->GetComponentScale();
-			Point Center((LocalHitPosition * Scale).X, (LocalHitPosition * Scale).Z);
-			ECircleIntersectionType IntersectionResult = CheckPieceCircleIntersection(Subject, FVector(Center.x, 0.0f, Center.z), ImpactRadius);
+	FGlassFractureEvent Event;
+	FVector LocalImpact = GetRootComponent()->GetComponentTransform().InverseTransformPosition(WorldHitLocation);
+	const float ImpactGrid = FractureResultCache::GetImpactGrid();
+	if (ImpactGrid > 0.0f)
+	{
+		// Nearby hits land on the same impact and can reuse one cached result
+		LocalImpact.X = FMath::GridSnap(LocalImpact.X, (double)ImpactGrid);
+		LocalImpact.Z = FMath::GridSnap(LocalImpact.Z, (double)ImpactGrid);
+	}
+	Event.LocalImpact = QuantizeTenths(LocalImpact);
+	Event.Impulse = QuantizeTenths(FVector(0.0f, ShardImpulse, 0.0f));
+	Event.Seed = EventSeedStream.RandHelper(MAX_int32);
+	Event.ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	Event.Index = FractureSnapshot.Impacts.Num() + FractureEvents.Num();
+
+	FlushNetDormancy();
+	FractureEvents.Add(Event);
+	if (FractureEvents.Num() > MaxFractureEvents)
+	{
+		FoldFractureHistory();
+	}
+	UE_CLOG(Event.Index + 1 == HistoryCap, LogGlassFracture, Warning, TEXT("%s: %d hits recorded, the replicated history is full and further hits are ignored"),
+		*GetName(), HistoryCap);
+	ApplyPendingEvents();
+}
 
-			if (IntersectionResult == ECircleIntersectionType::Outside) {
-				OutsidePieces.Add(Subject);
-				continue;
-			}
+void AShatterableGlass::OnRep_FractureEvents()
+{
+	ApplyPendingEvents();
+}
 
-			for (int32 j = 0; j < PatternCells.Num(); ++j) {
-				const Piece& Clip = PatternCells[j];
-
-				TArray<Point> ClippedPoints = PolygonClipper::PerformClipping(Subject.points, Clip.points);
-
-				if (ClippedPoints.Num() > 0) {
-					Piece NewPiece(ClippedPoints);
-					ECircleIntersectionType ClippedIntersectionResult = CheckPieceCircleIntersection(NewPiece, FVector(Center.x, 0.0f, Center.z), ImpactRadius);
-
-					switch (ClippedIntersectionResult) {
-					case ECircleIntersectionType::Inside:
-					case ECircleIntersectionType::Overlapping:
-						ClippedPieces.Add(NewPiece);
-						UE_LOG(LogTemp, Log, TEXT("Piece %d generated clipped piece %d"), j, PieceIndex);
-
-						if (!CellToPiecesMap.Contains(j)) {
-							CellToPiecesMap.Add(j, TArray<int32>());
-						}
-						CellToPiecesMap[j].Add(PieceIndex);
-						PieceIndex++;
-						break;
-					case ECircleIntersectionType::Outside:
-						UE_LOG(LogTemp, Log, TEXT("Clipped Piece is completely outside the circle."));
-						OutsidePieces.Add(NewPiece);
-						break;
-					}
-				}
-			}
-		}
-		UE_LOG(LogTemp, Warning, TEXT("number of clipped pieces: %d"), ClippedPieces.Num());
-		VisualizePieces(ClippedPieces, true, 0.0f);
+/* Every machine applies the same events in the same order */
+void AShatterableGlass::ApplyPendingEvents()
+{
+	// Events replicated before BeginPlay wait for the layout, BeginPlay applies them
+	if (!HasActorBegunPlay() && !IsActorBeginningPlay())
+	{
+		return;
+	}
 
-		if (Glass)
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	while (true)
+	{
+		// Folded hits are history by definition; late joiners replay them without shards
+		if (AppliedEvents < FractureSnapshot.Impacts.Num())
 		{
-			Glass->OnComponentHit.RemoveDynamic(this, &AShatterableGlass::OnHit);
-			Glass->DestroyComponent();
-			Glass = nullptr;
+			QueueHit(FractureSnapshot.Unfold(AppliedEvents++), false);
+			continue;
 		}
-		GeneratePieceMeshes(ClippedPieces, CellToPiecesMap);
-		GeneratePieceMeshes(OutsidePieces);
-		if (ShatterSound)
+
+		// The two properties can arrive in separate updates, so wait until the next event is actually here
+		const int32 Slot = FractureEvents.Num() > 0 ? AppliedEvents - FractureEvents[0].Index : INDEX_NONE;
+		if (!FractureEvents.IsValidIndex(Slot))
 		{
-			UGameplayStatics::PlaySoundAtLocation(this, ShatterSound, Hit.ImpactPoint);
+			break;
 		}
-		IntactPieces = MoveTemp(OutsidePieces);
+		const FGlassFractureEvent& Event = FractureEvents[Slot];
+		const bool bHistory = !HasAuthority() && GameState && GameState->GetServerWorldTimeSeconds() - Event.ServerTime > MaxShardReplayAge;
+		QueueHit(Event, !bHistory);
+		AppliedEvents++;
 	}
 }
 
-AShatterableGlass::ECircleIntersectionType 
-AShatterableGlass::CheckPieceCircleIntersection(const Piece& Piece, const FVector& CircleCenter, float Radius)
+/* The pane's root is its local space: the pattern is placed there and the impact circle is its (x, z) */
+void AShatterableGlass::QueueHit(const FGlassFractureEvent& Event, bool bSpawnShards)
 {
-	bool bAllInside = true;
-	bool bAnyInside = false;
+	const FTransform& PaneTransform = GetRootComponent()->GetComponentTransform();
 
-	for (const Point& point : Piece.points)
+	PendingHit NewHit;
+	NewHit.PatternLocation = Event.LocalImpact;
+	NewHit.ImpactCenter = FVector2D(Event.LocalImpact.X, Event.LocalImpact.Z);
+	NewHit.ImpactPoint = PaneTransform.TransformPosition(Event.LocalImpact);
+	NewHit.HitTime = FPlatformTime::Seconds();
+	NewHit.Seed = Event.Seed;
+	NewHit.Impulse = PaneTransform.TransformVectorNoScale(Event.Impulse);
+	NewHit.bSpawnShards = bSpawnShards;
+
+	DrawDebugSphere(GetWorld(), NewHit.ImpactPoint, 8.0f, 12, FColor::White, false, 0.0f);
+	DrawImpactCircle(NewHit.ImpactPoint, ImpactRadius, 0.0f);
+
+	if (FractureTask.IsValid())
 	{
-		float distanceSquared = FMath::Pow(point.x - CircleCenter.X, 2) + FMath::Pow(point.z - CircleCenter.Z, 2);
-		if (distanceSquared <= Radius * Radius)
-		{
-			bAnyInside = true;
-		}
-		else
+		// Applied against the in-flight result once it lands; never dropped, the server already capped the queue
+		QueuedHits.Add(NewHit);
+		return;
+	}
+	LaunchFracture(NewHit);
+}
+
+/* Moves the oldest events into the snapshot until FractureEvents is back at MaxFractureEvents */
+void AShatterableGlass::FoldFractureHistory()
+{
+	const int32 NumFolded = FractureEvents.Num() - MaxFractureEvents;
+	for (int32 i = 0; i < NumFolded; ++i)
+	{
+		FractureSnapshot.Fold(FractureEvents[i]);
+	}
+	FractureEvents.RemoveAt(0, NumFolded);
+}
+
+void AShatterableGlass::LaunchFracture(const PendingHit& Hit)
+{
+	LLM_SCOPE_BYTAG(GlassFracture);
+	InFlightCacheKey.Reset();
+
+	// The intact set is fully determined by the pane settings and the hits applied so far
+	FractureResultCache::Key CacheKey;
+	CacheKey.PaneState = CityHash64WithSeed((const char*)&HitHistoryHash, sizeof(HitHistoryHash), PaneSettingsHash);
+	CacheKey.ImpactCenter = Hit.ImpactCenter;
+	CacheKey.bRebuildAllSections = !bIntactSectionsBuilt;
+
+	// Lazy sites come from the history rather than a running stream, so a cached result matches what the job would have built
+	HitHistoryHash = CityHash64WithSeed((const char*)&Hit.ImpactCenter, sizeof(Hit.ImpactCenter), HitHistoryHash);
+	LazySiteStream.Initialize((int32)(uint32)HitHistoryHash);
+
+	if (FractureResultCache::IsEnabled())
+	{
+		if (TSharedPtr<const FractureJobResult> Cached = FractureResultCache::Get().Find(CacheKey))
 		{
-			bAllInside = false;
+			// Pane-local pieces, placed by this pane's transform when applied
+			InFlightHit = Hit;
+			ApplyFracture(*Cached, true);
+			return;
 		}
+		InFlightCacheKey = CacheKey;
 	}
 
-	if (bAllInside) 
+	FractureJobInput Input;
+
+	// The job owns the intact set until its result is applied
+	Input.IntactPieces = MoveTemp(IntactPieces);
+	Input.CoarsePieces = MoveTemp(CoarsePieces);
+	Input.Backend = VoronoiBackend;
+	Input.PaneBounds = GetPaneBox();
+	Input.SectionTiles = IntactSectionTiles;
+	Input.bRebuildAllSections = !bIntactSectionsBuilt;
+	Input.Hulls.Thickness = FMath::Max(GlassThickness, 0.1f);
+	Input.Hulls.MaxVertices = MaxHullVertices;
+	Input.Hulls.ProxySize = ShardProxySize;
+	PrepareRefinement(Hit, Input);
+	Input.PatternLocation = Hit.PatternLocation;
+	Input.ImpactCenter = Hit.ImpactCenter;
+	Input.ImpactRadius = ImpactRadius;
+	Input.Pattern = ActivePattern;
+
+	InFlightHit = Hit;
+	FractureTask = UE::Tasks::Launch(UE_SOURCE_LOCATION, [Input = MoveTemp(Input)]()
 	{
-		return ECircleIntersectionType::Inside;
+		return FractureJob::Run(Input);
+	});
+
+	SetActorTickEnabled(true);
+}
+
+/* Samples sites around the impact at the same density as a full pane layout, if any coarse piece lies there */
+void AShatterableGlass::PrepareRefinement(const PendingHit& Hit, FractureJobInput& Input)
+{
+	if (Input.CoarsePieces.Num() == 0)
+	{
+		return;
 	}
-	if (bAnyInside)
+
+	// Pieces touching the impact circle get clipped by the pattern; the margin keeps those pieces inside refined cells
+	const FBox2D PaneBox = GetPaneBox();
+	const FVector2D Reach(ImpactRadius + 2.0f * SiteMinDistance);
+	const FBox2D Region(
+		FVector2D(FMath::Max(Hit.ImpactCenter.X - Reach.X, PaneBox.Min.X), FMath::Max(Hit.ImpactCenter.Y - Reach.Y, PaneBox.Min.Y)),
+		FVector2D(FMath::Min(Hit.ImpactCenter.X + Reach.X, PaneBox.Max.X), FMath::Min(Hit.ImpactCenter.Y + Reach.Y, PaneBox.Max.Y)));
+
+	const bool bTouchesCoarse = Input.CoarsePieces.ContainsByPredicate([&Region](const Piece& Coarse) {
+		return Coarse.bounds.Intersect(Region);
+	});
+	if (!bTouchesCoarse || Region.Min.X >= Region.Max.X || Region.Min.Y >= Region.Max.Y)
 	{
-		return ECircleIntersectionType::Overlapping;
+		return;
+	}
+
+	const FBox2D SampleBox = Region.ExpandBy(SiteMinDistance);
+	const double PaneArea = PaneBox.ExpandBy(SiteEdgeOffset).GetArea();
+	const int32 RegionSites = FMath::Max(FMath::CeilToInt32(NumSites * SampleBox.GetArea() / PaneArea), 3);
+
+	Input.RefineSites = GenerateRandomPoints(LazySiteStream, SampleBox, SiteMinDistance, RegionSites);
+	Input.RefineRegion = Region;
+}
+
+/* Results may be shared with the cache, so the pieces the pane keeps are copied out */
+void AShatterableGlass::ApplyFracture(const FractureJobResult& Result, bool bFromCache)
+{
+	GLASSFRACTURE_SCOPE(Apply);
+	CSV_SCOPED_TIMING_STAT(GlassFracture, ApplyFracture);
+	LLM_SCOPE_BYTAG(GlassFracture);
+	const double ApplyStartTime = FPlatformTime::Seconds();
+
+	PatternCells = Result.PatternCells;
+	VisualizePieces(PatternCells, false, 0.0f);
+
+	UE_LOG(LogGlassFracture, Verbose, TEXT("number of clipped pieces: %d"), Result.ClippedPieces.Num());
+	VisualizePieces(Result.ClippedPieces, true, 0.0f);
+
+	if (Glass)
+	{
+		Glass->OnComponentHit.RemoveDynamic(this, &AShatterableGlass::OnHit);
+		Glass->DestroyComponent();
+		Glass = nullptr;
+	}
+	if (InFlightHit.bSpawnShards)
+	{
+		GeneratePieceMeshes(Result.CellSections, Result.ClippedHulls, Result.CellToPiecesMap);
+	}
+	GeneratePieceMeshes(Result.DirtySections, Result.SectionMeshes, Result.OutsideHulls);
+	bIntactSectionsBuilt = true;
+	if (ShatterSound && InFlightHit.bSpawnShards)
+	{
+		UGameplayStatics::PlaySoundAtLocation(this, ShatterSound, InFlightHit.ImpactPoint);
+	}
+	IntactPieces = Result.OutsidePieces;
+	CoarsePieces = Result.CoarsePieces;
+
+	int32 ShardHullVertices = 0;
+	for (const TArray<FVector>& Hull : Result.ClippedHulls)
+	{
+		ShardHullVertices += Hull.Num();
+	}
+
+	CSV_CUSTOM_STAT(GlassFracture, ShardsSpawned, Result.CellToPiecesMap.Num(), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(GlassFracture, SectionsRebuilt, Result.DirtySections.Num(), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(GlassFracture, PiecesClipped, Result.ClippedPieces.Num(), ECsvCustomStatOp::Accumulate);
+
+	const double Now = FPlatformTime::Seconds();
+	LastApplyMs = float((Now - ApplyStartTime) * 1000.0);
+	LastFractureLatencyMs = float((Now - InFlightHit.HitTime) * 1000.0);
+
+	UE_LOG(LogGlassFracture, Log, TEXT("Fracture applied: compute %.2f ms, game thread %.2f ms, hit-to-apply %.2f ms, %d shard hulls with %d vertices"),
+		bFromCache ? 0.0 : Result.ComputeSeconds * 1000.0, LastApplyMs, LastFractureLatencyMs, Result.ClippedHulls.Num(), ShardHullVertices);
+
+	UpdatePeakMemory();
+}
+
+GlassMemoryUsage AShatterableGlass::GetMemoryUsage() const
+{
+	GlassMemoryUsage Usage;
+	Usage.AddPieces(IntactPieces);
+	Usage.AddPieces(CoarsePieces);
+	Usage.AddPieces(PatternCells);
+	Usage.AddPieces(GridPolygons);
+	Usage.Geometry += QueuedHits.GetAllocatedSize() + FractureEvents.GetAllocatedSize() + FractureSnapshot.Impacts.GetAllocatedSize();
+
+	Usage.AddComponent(Glass);
+	Usage.AddComponent(ProcMesh);
+	return Usage;
+}
+
+void AShatterableGlass::UpdatePeakMemory()
+{
+	const GlassMemoryUsage Usage = GetMemoryUsage();
+	if (Usage.Total() > PeakMemory.Total())
+	{
+		PeakMemory = Usage;
 	}
-	return ECircleIntersectionType::Outside;
 }
 
 void AShatterableGlass::CreateGridPolygons(int32 rows, int32 cols)
@@ -230,120 +585,107 @@ void AShatterableGlass::CreateGridPolygons(int32 rows, int32 cols)
 	}
 }
 
-void AShatterableGlass::GeneratePieceMeshes(const TArray<Piece>& Pieces)
+/* Rebuilds only the intact sections the hit changed; each piece keeps its own convex hull */
+void AShatterableGlass::GeneratePieceMeshes(const TArray<int32>& DirtySections, const TArray<PieceMeshData>& SectionMeshes, const TArray<TArray<FVector>>& Hulls)
 {
-	ProcMesh->ClearAllMeshSections();
-
-	int32 SectionIndex = 0;
-	for (const Piece& Piece : Pieces)
 	{
-		TArray<int32> TriangleIndices;
-		TArray<FVector> MeshVertices;
-
-		FanTriangulation(Piece.points, TriangleIndices, MeshVertices);
+		GLASSFRACTURE_SCOPE(MeshSections);
+		for (int32 k = 0; k < DirtySections.Num(); ++k)
+		{
+			const int32 SectionIndex = DirtySections[k];
+			const PieceMeshData& Section = SectionMeshes[k];
 
-		ProcMesh->AddCollisionConvexMesh(MeshVertices);
-		if (GlassMaterial) {
-			ProcMesh->SetMaterial(SectionIndex, GlassMaterial);
+			if (Section.Triangles.Num() == 0)
+			{
+				ProcMesh->ClearMeshSection(SectionIndex);
+				continue;
+			}
+			ProcMesh->CreateMeshSection(SectionIndex, Section.Vertices, Section.Triangles, Section.Normals, Section.UVs, TArray<FColor>(), Section.Tangents, true);
+			if (GlassMaterial) {
+				ProcMesh->SetMaterial(SectionIndex, GlassMaterial);
+			}
 		}
-		ProcMesh->CreateMeshSection(SectionIndex, MeshVertices, TriangleIndices, TArray<FVector>(), TArray<FVector2D>(), TArray<FColor>(), TArray<FProcMeshTangent>(), true);
-		SectionIndex++;
 	}
 
-	ProcMesh->RecreatePhysicsState();
+	if (DirtySections.Num() == 0)
+	{
+		return;
+	}
+
+	// The body setup holds every hull, so it is replaced as a whole and cooked off the game thread
+	GLASSFRACTURE_SCOPE(PhysicsState);
+	ProcMesh->SetCollisionConvexMeshes(Hulls);
+
 	//ProcMesh->ContainsPhysicsTriMeshData(true);
 	//ProcMesh->UpdateCollision();
 }
 
-void AShatterableGlass::GeneratePieceMeshes(const TArray<Piece>& Pieces, const TMap<int32, TArray<int32>>& CellToPiecesMap)
+void AShatterableGlass::GeneratePieceMeshes(const TMap<int32, PieceMeshData>& Sections, const TArray<TArray<FVector>>& Hulls, const TMap<int32, TArray<int32>>& CellToPiecesMap)
 {
+	UGlassShardSubsystem* ShardPool = GetWorld()->GetSubsystem<UGlassShardSubsystem>();
+	if (!ShardPool)
+	{
+		return;
+	}
+
+	const FTransform& PaneTransform = GetRootComponent()->GetComponentTransform();
+	TArray<FVector> ShardVertices;
+
+	// Cells come sorted and the jitter is seeded by the hit, so every machine launches the same shards the same way
+	FRandomStream ShardStream(InFlightHit.Seed);
+	const FVector ImpulseDirection = InFlightHit.Impulse.GetSafeNormal();
+	const float ImpulseStrength = InFlightHit.Impulse.Size();
+	INC_DWORD_STAT_BY(STAT_GlassFracture_ShardsSpawned, CellToPiecesMap.Num());
+
 	for (const auto& Pair : CellToPiecesMap)
 	{
 		int32 CellIndex = Pair.Key;
 		const TArray<int32>& PieceIndices = Pair.Value;
+		const PieceMeshData& Section = Sections.FindChecked(CellIndex);
 
-		// Dynamically create a procedural mesh component for each cell piece
-		FString PieceName = FString::Printf(TEXT("CellPiece_%d"), CellIndex);
-		UProceduralMeshComponent* PieceMesh = NewObject<UProceduralMeshComponent>(this, *PieceName);
-		PieceMesh->RegisterComponent();
-		PieceMesh->AttachToComponent(GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+		// The cell is one rigid body, so its pieces render as one section over one convex hull each
+		TArray<TArray<FVector>> ConvexMeshes;
+		ConvexMeshes.Reserve(PieceIndices.Num());
+		for (const int32 PieceIndex : PieceIndices)
+		{
+			ConvexMeshes.Add(Hulls[PieceIndex]);
+		}
 
-		// Set collision profile
-		PieceMesh->SetCollisionProfileName(TEXT("BlockAll"));
-		PieceMesh->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Block);
-		PieceMesh->SetCollisionEnabled(ECollisionEnabled::QueryAndPhysics);
-		PieceMesh->SetCollisionObjectType(ECollisionChannel::ECC_PhysicsBody);
+		// Cooked collision is shared by shape, so the shard sits at the hulls' origin instead of the pane's
+		FVector Origin;
+		UBodySetup* ShardBody = ShardPool->FindOrCookHulls(ConvexMeshes, Origin);
 
-		// Configure collision settings
-		PieceMesh->bUseComplexAsSimpleCollision = false;
-		PieceMesh->SetSimulatePhysics(true);
-		PieceMesh->bAlwaysCreatePhysicsState = true;
+		// Take a registered, pre-configured component from the world's shard pool
+		UGlassShardComponent* PieceMesh = ShardPool->AcquireShard(FTransform(Origin) * PaneTransform);
 
-		int32 SectionIndex = 0;
-		for (const int32 PieceIndex : PieceIndices)
+		// Scoped apart from the cook and the launch, which count under their own stages
 		{
-			const Piece& Piece = Pieces[PieceIndex];
-
-			TArray<int32> TriangleIndices;
-			TArray<FVector> MeshVertices;
-			FanTriangulation(Piece.points, TriangleIndices, MeshVertices);
+			GLASSFRACTURE_SCOPE(MeshSections);
+			ShardVertices = Section.Vertices;
+			for (FVector& Vertex : ShardVertices)
+			{
+				Vertex -= Origin;
+			}
 
 			PieceMesh->CreateMeshSection(
-				SectionIndex,                  // Section index
-				MeshVertices,                  // Vertex data for the mesh
-				TriangleIndices,               // Triangle faces
-				TArray<FVector>(),             // Empty normals array
-				TArray<FVector2D>(),           // Empty UVs array
+				0,                             // Section index
+				ShardVertices,                 // Vertex data of every piece in the cell
+				Section.Triangles,             // Triangle faces
+				Section.Normals,               // Flat normals of the slab faces and rim
+				Section.UVs,                   // Planar UVs over the pane
 				TArray<FColor>(),              // Empty vertex colors array
-				TArray<FProcMeshTangent>(),    // Empty tangents array
-				true                           // Enable collision
+				Section.Tangents,              // Tangents along U
+				false                          // Collision comes from the shared body
 			);
-
-			PieceMesh->AddCollisionConvexMesh(MeshVertices);
 			if (GlassMaterial) {
-				PieceMesh->SetMaterial(SectionIndex, GlassMaterial);
+				PieceMesh->SetMaterial(0, GlassMaterial);
 			}
-
-			SectionIndex++;
 		}
 
-		// Apply an impulse in a randomly varied direction based on the Y-axis.
-		FVector ImpactDirection = FVector(0.0f, 1.0f, 0.0f) + FMath::VRand() * 0.2f;
+		// Apply an impulse in a randomly varied direction around the hit's impulse, once the shard's body is cooked
+		FVector ImpactDirection = ImpulseDirection + ShardStream.VRand() * 0.2f;
 		ImpactDirection = ImpactDirection.GetSafeNormal();
-		float ImpulseStrength = 300.0f;
-		PieceMesh->AddImpulse(ImpactDirection * ImpulseStrength, NAME_None, true);
-		PieceMesh->WakeRigidBody();
-	}
-}
-
-void AShatterableGlass::FanTriangulation(const Piece& Piece, TArray<int32>& Triangles, TArray<FVector>& MeshVertices)
-{
-	const TArray<Point>& Points = Piece.points;
-
-	// Front face vertices & triangles
-	int32 FrontFaceOffset = MeshVertices.Num();
-	for (const Point& point : Points)
-	{
-		MeshVertices.Add(FVector(point.x, 0.0f, point.z));
-	}
-	for (int32 i = 1; i < Points.Num() - 1; i++)
-	{
-		Triangles.Add(FrontFaceOffset);
-		Triangles.Add(FrontFaceOffset + i);
-		Triangles.Add(FrontFaceOffset + i + 1);
-	}
-
-	// Back face (reverse winding order)
-	int32 BackFaceOffset = MeshVertices.Num();
-	for (const Point& point : Points)
-	{
-		MeshVertices.Add(FVector(point.x, 0.0f, point.z));
-	}
-	for (int32 i = 1; i < Points.Num() - 1; i++)
-	{
-		Triangles.Add(BackFaceOffset);
-		Triangles.Add(BackFaceOffset + i + 1);
-		Triangles.Add(BackFaceOffset + i);
+		ShardPool->LaunchShard(PieceMesh, ShardBody, ImpactDirection * ImpulseStrength);
 	}
 }
 
@@ -393,46 +735,24 @@ void AShatterableGlass::DrawImpactCircle(const FVector& ImpactPosition, float Ra
 	}
 }
 
-TArray<Point> AShatterableGlass::GenerateRandomPoints(float MinDistance, int32 NumPoints, float EdgeOffset)
+TArray<Point> AShatterableGlass::GenerateRandomPoints(FRandomStream& Stream, const FBox2D& Region, float MinDistance, int32 NumPoints)
 {
-	TArray<Point> RandomPoints;
-	TArray<FVector> PoissonPoints;
-
-	const int32 MaxAttempts = 30;
+	SiteDensitySettings Density;
+	Density.Mode = SiteDensity;
+	Density.DenseSpacing = DenseSiteSpacing;
+	Density.Falloff = DensityFalloff;
+	Density.Frame = GetPaneBox();
+	Density.Focus = PredictedImpact;
 
-	FVector AdjustedMin = LocalMinBound - FVector(EdgeOffset, 0.0f, EdgeOffset);
-	FVector AdjustedMax = LocalMaxBound + FVector(EdgeOffset, 0.0f, EdgeOffset);
+	TArray<Point> RandomPoints = PoissonDiskSampler::Sample(Stream, Region, MinDistance, NumPoints, Density);
 
-	for (int32 i = 0; i < NumPoints; ++i)
+	if (bDrawSites)
 	{
-		FVector CandidatePoint;
-		bool IsValid = false;
-
-		for (int32 attempt = 0; attempt < MaxAttempts; ++attempt)
+		for (const Point& Site : RandomPoints)
 		{
-			CandidatePoint = FVector(
-				FMath::RandRange(AdjustedMin.X, AdjustedMax.X),
-				0.0f,
-				FMath::RandRange(AdjustedMin.Z, AdjustedMax.Z)
-			);
-			IsValid = true;
-			for (const FVector& ExistingPoint : PoissonPoints)
-			{
-				if (FVector::DistSquared(CandidatePoint, ExistingPoint) < FMath::Square(MinDistance))
-				{
-					IsValid = false;
-					break;
-				}
-			}
-			if (IsValid) break;
-		}
-		if (IsValid)
-		{
-			PoissonPoints.Add(CandidatePoint);
-			RandomPoints.Add(Point(CandidatePoint.X, CandidatePoint.Z));
-			DrawDebugSphere(GetWorld(), CandidatePoint + GetActorLocation(), 4.0f, 12, FColor::Orange, false, 0.0f);
+			DrawDebugSphere(GetWorld(), FVector(Site.x, 0.0f, Site.z) + GetActorLocation(), 4.0f, 12, FColor::Orange, false, 0.0f);
 		}
 	}
 
 	return RandomPoints;
-}
\ No newline at end of file
+}
@@ -5,11 +5,63 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "TriangulationTypes.h"
+#include "FractureJob.h"
+#include "FractureResultCache.h"
+#include "GlassMemoryUsage.h"
+#include "PatternCells/FracturePatternAsset.h"
+#include "VoronoiDiagram/VoronoiBackend.h"
+#include "VoronoiDiagram/PaneLayoutAsset.h"
+#include "VoronoiDiagram/SiteDensity.h"
 #include "ProceduralMeshComponent.h"
 #include "Engine/DataTable.h"
+#include "Tasks/Task.h"
 
 #include "ShatterableGlass.generated.h"
 
+/**
+ * One hit as the server saw it. Clients rebuild the same pieces from it, so no shard or mesh data is replicated.
+ * The pane is the replicating actor itself, so it needs no ID of its own.
+ */
+USTRUCT()
+struct FGlassFractureEvent
+{
+	GENERATED_BODY()
+
+	// Pane-local, already rounded to the replicated precision on the server
+	UPROPERTY()	FVector_NetQuantize10 LocalImpact = FVector::ZeroVector;
+	UPROPERTY()	FVector_NetQuantize10 Impulse = FVector::ZeroVector;
+
+	// Seeds the shard impulse jitter
+	UPROPERTY()	int32 Seed = 0;
+
+	// Server world time of the hit; older events reaching a late joiner rebuild the pane without spawning shards
+	UPROPERTY()	float ServerTime = 0.0f;
+
+	// Position in the whole hit history, folded hits included, so a client never applies events against the wrong snapshot
+	UPROPERTY()	int32 Index = 0;
+};
+
+/**
+ * The oldest hits, folded in by the server once FractureEvents is full. Only the impact decides which pieces break,
+ * so a late joiner replaying these without shards rebuilds the server's pane; 8 bytes per hit whatever the pane's density.
+ */
+USTRUCT()
+struct FGlassFractureSnapshot
+{
+	GENERATED_BODY()
+
+	// Pane-local (X, Z) in tenths, as FVector_NetQuantize10 sends them; Impacts[i] is hit i
+	UPROPERTY()	TArray<FIntPoint> Impacts;
+
+	void Fold(const FGlassFractureEvent& Event);
+	FGlassFractureEvent Unfold(int32 Index) const;
+};
+
+/**
+ * Glass pane fractured by hits. On a network the server records every accepted hit as an FGlassFractureEvent
+ * and every machine applies the events in order; layouts, lazy sites and shard impulses all come from per-pane streams.
+ * Try it with Play As Listen Server and two or more clients, joining a client late to see the history replayed.
+ */
 UCLASS()
 class GLASSFRACTURE_API AShatterableGlass : public AActor
 {
@@ -22,6 +74,8 @@ public:
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UPROPERTY(VisibleAnywhere)
 	UStaticMeshComponent* Glass;
@@ -33,39 +87,138 @@ protected:
 	USoundBase* ShatterSound;
 
 public:
+	// Applies finished fracture jobs; only enabled while a job is in flight
+	virtual void Tick(float DeltaTime) override;
+
+#if WITH_EDITOR
+	// Stores this pane's layout in LayoutAsset under its current size and LayoutSeed
+	UFUNCTION(CallInEditor, Category = "Voronoi")
+	void BakeLayout();
+#endif
+
+	/* Bytes held by this pane now, and at its largest so far */
+	GlassMemoryUsage GetMemoryUsage() const;
+	const GlassMemoryUsage& GetPeakMemoryUsage() const { return PeakMemory; }
+
+	/* Fractures the pane as if hit at WorldHitLocation, for scripted impacts; only the server's hits count on a network */
+	void ApplyImpact(const FVector& WorldHitLocation);
+
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComp, AActor* OtherActor, UPrimitiveComponent* OtherComp, FVector NormalImpulse, const FHitResult& Hit);
 
 private:
-	enum class ECircleIntersectionType
+	struct PendingHit
 	{
-		Inside,      // Fully contained within the circle
-		Overlapping, // Partially overlapping with the circle
-		Outside      // Completely outside the circle
+		FVector PatternLocation;
+		FVector2D ImpactCenter;
+		FVector ImpactPoint;
+		double HitTime;
+		int32 Seed = 0;
+		FVector Impulse = FVector::ZeroVector;	// World space, jittered per shard
+		bool bSpawnShards = true;
 	};
 
 	UPROPERTY(VisibleAnywhere)	FVector LocalMinBound;
 	UPROPERTY(VisibleAnywhere)	FVector LocalMaxBound;
 
+	// Compiled pattern; when unset, one is built from the DataTables at BeginPlay
+	UPROPERTY(EditAnywhere, Category = "FracturePattern")	UFracturePatternAsset* PatternAsset;
 	UPROPERTY(EditAnywhere, Category = "FracturePattern")	UDataTable* PolygonDataTable;
 	UPROPERTY(EditAnywhere, Category = "FracturePattern")	UDataTable* VertexDataTable;
+	UPROPERTY(Transient)	UFracturePatternAsset* ActivePattern;
+
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	EVoronoiBackend VoronoiBackend = EVoronoiBackend::Delaunay;
+
+	// Baked layouts are looked up by pane size and seed and only used while the settings below match the bake; otherwise the layout is generated at BeginPlay
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	UPaneLayoutAsset* LayoutAsset;
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	int32 LayoutSeed = 0;
+
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	int32 NumSites = 70;
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	float SiteMinDistance = 50.0f;
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	float SiteEdgeOffset = 60.0f;
+
+	// Spacing shrinks to DenseSiteSpacing times normal at the frame or around PredictedImpact (pane-local X, Z)
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	ESiteDensity SiteDensity = ESiteDensity::Uniform;
+	UPROPERTY(EditAnywhere, Category = "Voronoi", meta = (ClampMin = "0.1", ClampMax = "1.0"))	float DenseSiteSpacing = 0.5f;
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	float DensityFalloff = 100.0f;
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	FVector2D PredictedImpact = FVector2D::ZeroVector;
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	bool bDrawSites = false;
+
+	// Keep the pane as one coarse piece until hit, then only generate cells around each impact
+	UPROPERTY(EditAnywhere, Category = "Voronoi")	bool bLazyPreFracture = false;
+
+	// Hits arriving while a fracture is being computed are applied in order afterwards, up to this many
+	UPROPERTY(EditAnywhere, Category = "Fracture")	int32 MaxQueuedHits = 4;
+	UPROPERTY(EditAnywhere, Category = "Fracture")	float ImpactRadius = 80.0f;
+	UPROPERTY(EditAnywhere, Category = "Fracture")	float ShardImpulse = 300.0f;
+
+	// Replicated hit history: the recent events in full, everything older folded into a snapshot, so late joiners can replay it
+	UPROPERTY(ReplicatedUsing = OnRep_FractureEvents)	TArray<FGlassFractureEvent> FractureEvents;
+	UPROPERTY(ReplicatedUsing = OnRep_FractureEvents)	FGlassFractureSnapshot FractureSnapshot;
+	UPROPERTY(EditAnywhere, Category = "Fracture", meta = (ClampMin = "1", ClampMax = "256"))	int32 MaxFractureEvents = 64;
+
+	// The pane ignores hits once this many are folded; kept under net.MaxRepArraySize (2048) so the snapshot always replicates
+	UPROPERTY(EditAnywhere, Category = "Fracture", meta = (ClampMin = "0", ClampMax = "2048"))	int32 MaxFoldedImpacts = 1024;
+
+	// The intact pane is drawn as a grid of sections; a hit only rebuilds the sections it changed
+	UPROPERTY(EditAnywhere, Category = "Fracture", meta = (ClampMin = "1", ClampMax = "16"))	int32 IntactSectionTiles = 4;
+
+	// Collision hulls and render slabs are GlassThickness deep, with at most MaxHullVertices corners per hull
+	// The pane mesh is scaled flat along Y, so its own depth is no guide
+	UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "0.1"))	float GlassThickness = 1.5f;
+	UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "8", ClampMax = "64"))	int32 MaxHullVertices = 16;
+	// Shards no larger than this collide as a box, 0 disables
+	UPROPERTY(EditAnywhere, Category = "Collision", meta = (ClampMin = "0.0"))	float ShardProxySize = 0.0f;
+
+	// Time from hit to the result being applied, and the game-thread share of it
+	UPROPERTY(VisibleAnywhere, Category = "Fracture")	float LastFractureLatencyMs = 0.0f;
+	UPROPERTY(VisibleAnywhere, Category = "Fracture")	float LastApplyMs = 0.0f;
 
 	TArray<Piece> PatternCells;
 	TArray<Piece> GridPolygons;
 	TArray<Piece> IntactPieces;
+	TArray<Piece> CoarsePieces;
+	FRandomStream LazySiteStream;
+	FRandomStream EventSeedStream;
+	uint64 PaneSettingsHash = 0;	// Everything the starting layout and the fracture depend on, for result cache keys
+	uint64 HitHistoryHash = 0;		// Advanced by every applied hit, the same on every machine
+	int32 AppliedEvents = 0;		// Queued so far, counting the ones folded into the snapshot
+	bool bIntactSectionsBuilt = false;
+	GlassMemoryUsage PeakMemory;
 
 	UMaterialInterface* GlassMaterial = nullptr;
 
+	UE::Tasks::TTask<FractureJobResult> FractureTask;
+	PendingHit InFlightHit;
+	TOptional<FractureResultCache::Key> InFlightCacheKey;
+	TArray<PendingHit> QueuedHits;
+
+	void HandleImpact(UPrimitiveComponent* HitComp, const FVector& WorldHitLocation);
+
+	UFUNCTION()
+	void OnRep_FractureEvents();
+	void ApplyPendingEvents();
+	void QueueHit(const FGlassFractureEvent& Event, bool bSpawnShards);
+	void FoldFractureHistory();
+	void LaunchFracture(const PendingHit& Hit);
+	void ApplyFracture(const FractureJobResult& Result, bool bFromCache = false);
+	void UpdatePeakMemory();
+
+	void ComputeLocalBounds();
+	FVector2D GetPaneSize() const { return FVector2D(LocalMaxBound.X - LocalMinBound.X, LocalMaxBound.Z - LocalMinBound.Z); }
+	FBox2D GetPaneBox() const { return FBox2D(FVector2D(LocalMinBound.X, LocalMinBound.Z), FVector2D(LocalMaxBound.X, LocalMaxBound.Z)); }
+	TArray<Piece> GeneratePaneLayout();
+	uint64 GetLayoutSettingsHash() const;
+	void PrepareRefinement(const PendingHit& Hit, FractureJobInput& Input);
+
 	void CreateGridPolygons(int32 rows, int32 cols);
-	void GeneratePieceMeshes(const TArray<Piece>& Pieces);
-	void GeneratePieceMeshes(const TArray<Piece>& Pieces, const TMap<int32, TArray<int32>>& CellToPiecesMap);
-	void FanTriangulation(const Piece& Piece, TArray<int32>& Triangles, TArray<FVector>& MeshVertices);
+	void GeneratePieceMeshes(const TArray<int32>& DirtySections, const TArray<PieceMeshData>& SectionMeshes, const TArray<TArray<FVector>>& Hulls);
+	void GeneratePieceMeshes(const TMap<int32, PieceMeshData>& Sections, const TArray<TArray<FVector>>& Hulls, const TMap<int32, TArray<int32>>& CellToPiecesMap);
 
 	template <typename T>
 	void VisualizePieces(const TArray<T>& Pieces, bool bRandomizeColor, float Duration);
 
 	void DrawImpactCircle(const FVector& ImpactPosition, float Radius, float Duration = 5.0f, const FColor& Color = FColor::White, float Thickness = 2.0f, int32 NumSegments = 36);
-	ECircleIntersectionType CheckPieceCircleIntersection(const Piece& Piece, const FVector& CircleCenter, float Radius);
 
-	TArray<Point> GenerateRandomPoints(float MinDistance, int32 NumPoints, float EdgeOffset = 10.0f);
+	TArray<Point> GenerateRandomPoints(FRandomStream& Stream, const FBox2D& Region, float MinDistance, int32 NumPoints);
 };
@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SlabMeshBuilder.h"
+
+void SlabMeshBuilder::BuildSection(TArrayView<const Piece* const> Pieces, TArrayView<const int32> Selected, const SlabSettings& Settings, PieceMeshData& OutMesh)
+{
+	int32 TotalVertices = 0;
+	int32 TotalIndices = 0;
+	for (int32 Index : Selected) {
+		const Piece* P = Pieces[Index];
+		if (P->points.Num() >= 3) {
+			TotalVertices += NumVertices(P->points.Num());
+			TotalIndices += NumIndices(P->points.Num());
+		}
+	}
+
+	OutMesh.Vertices.SetNumUninitialized(TotalVertices);
+	OutMesh.Normals.SetNumUninitialized(TotalVertices);
+	OutMesh.UVs.SetNumUninitialized(TotalVertices);
+	OutMesh.Tangents.SetNumUninitialized(TotalVertices);
+	OutMesh.Triangles.SetNumUninitialized(TotalIndices);
+
+	int32 VertexOffset = 0;
+	int32 IndexOffset = 0;
+	for (int32 Index : Selected) {
+		const Piece* P = Pieces[Index];
+		if (P->points.Num() >= 3) {
+			WriteSlab(*P, Settings, OutMesh, VertexOffset, IndexOffset);
+			VertexOffset += NumVertices(P->points.Num());
+			IndexOffset += NumIndices(P->points.Num());
+		}
+	}
+}
+
+void SlabMeshBuilder::WriteSlab(const Piece& Piece, const SlabSettings& Settings, PieceMeshData& Mesh, int32 VertexOffset, int32 IndexOffset)
+{
+	const TArray<Point>& Points = Piece.points;
+	const int32 N = Points.Num();
+	if (N < 3) {
+		return;
+	}
+
+	// Walk the outline counter-clockwise in (x, z) whatever the piece's winding, so faces and rim always point outwards
+	double TwiceArea = 0.0;
+	for (int32 i = 0; i < N; ++i) {
+		const Point& A = Points[i];
+		const Point& B = Points[(i + 1) % N];
+		TwiceArea += (double)A.x * B.z - (double)A.z * B.x;
+	}
+	const bool bReversed = TwiceArea < 0.0;
+	auto Corner = [&Points, N, bReversed](int32 i) {
+		const Point& P = Points[bReversed ? N - 1 - i : i];
+		return FVector2D(P.x, P.z);
+	};
+
+	const float HalfThickness = 0.5f * Settings.Thickness;
+	const FVector2D UVSize = Settings.UVBounds.GetSize();
+	const FVector2D UVScale(UVSize.X > 0.0 ? 1.0 / UVSize.X : 0.0, UVSize.Y > 0.0 ? 1.0 / UVSize.Y : 0.0);
+
+	FVector* Positions = Mesh.Vertices.GetData() + VertexOffset;
+	FVector* Normals = Mesh.Normals.GetData() + VertexOffset;
+	FVector2D* UVs = Mesh.UVs.GetData() + VertexOffset;
+	FProcMeshTangent* Tangents = Mesh.Tangents.GetData() + VertexOffset;
+	int32* Indices = Mesh.Triangles.GetData() + IndexOffset;
+
+	const int32 Front = VertexOffset;
+	const int32 Back = VertexOffset + N;
+	const int32 Rim = VertexOffset + 2 * N;
+
+	// Faces share one planar projection of the pane, V pointing down
+	for (int32 i = 0; i < N; ++i) {
+		const FVector2D C = Corner(i);
+		const FVector2D UV((C.X - Settings.UVBounds.Min.X) * UVScale.X, (Settings.UVBounds.Max.Y - C.Y) * UVScale.Y);
+
+		Positions[i] = FVector(C.X, HalfThickness, C.Y);
+		Normals[i] = FVector(0.0, 1.0, 0.0);
+		UVs[i] = UV;
+		Tangents[i] = FProcMeshTangent(FVector(1.0, 0.0, 0.0), false);
+
+		Positions[N + i] = FVector(C.X, -HalfThickness, C.Y);
+		Normals[N + i] = FVector(0.0, -1.0, 0.0);
+		UVs[N + i] = UV;
+		Tangents[N + i] = FProcMeshTangent(FVector(1.0, 0.0, 0.0), true);
+	}
+
+	// Rim quads are flat shaded; U runs along the edge and V across the thickness
+	for (int32 i = 0; i < N; ++i) {
+		const FVector2D A = Corner(i);
+		const FVector2D B = Corner((i + 1) % N);
+		const FVector2D Along = (B - A).GetSafeNormal();
+		const FVector Outward(Along.Y, 0.0, -Along.X);
+		const FVector Tangent(Along.X, 0.0, Along.Y);
+		const double U = FVector2D::Distance(A, B) * UVScale.X;
+		const double V = Settings.Thickness * UVScale.Y;
+
+		const int32 Quad = 2 * N + 4 * i;
+		Positions[Quad + 0] = FVector(A.X, HalfThickness, A.Y);
+		Positions[Quad + 1] = FVector(B.X, HalfThickness, B.Y);
+		Positions[Quad + 2] = FVector(B.X, -HalfThickness, B.Y);
+		Positions[Quad + 3] = FVector(A.X, -HalfThickness, A.Y);
+		UVs[Quad + 0] = FVector2D(0.0, 0.0);
+		UVs[Quad + 1] = FVector2D(U, 0.0);
+		UVs[Quad + 2] = FVector2D(U, V);
+		UVs[Quad + 3] = FVector2D(0.0, V);
+		for (int32 k = 0; k < 4; ++k) {
+			Normals[Quad + k] = Outward;
+			Tangents[Quad + k] = FProcMeshTangent(Tangent, false);
+		}
+	}
+
+	int32 k = 0;
+	for (int32 i = 1; i < N - 1; ++i) {
+		Indices[k++] = Front;
+		Indices[k++] = Front + i;
+		Indices[k++] = Front + i + 1;
+	}
+	for (int32 i = 1; i < N - 1; ++i) {
+		Indices[k++] = Back;
+		Indices[k++] = Back + i + 1;
+		Indices[k++] = Back + i;
+	}
+	for (int32 i = 0; i < N; ++i) {
+		const int32 Quad = Rim + 4 * i;
+		Indices[k++] = Quad;
+		Indices[k++] = Quad + 2;
+		Indices[k++] = Quad + 1;
+		Indices[k++] = Quad;
+		Indices[k++] = Quad + 3;
+		Indices[k++] = Quad + 2;
+	}
+}
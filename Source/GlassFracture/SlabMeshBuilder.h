@@ -0,0 +1,40 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ProceduralMeshComponent.h"
+#include "TriangulationTypes.h"
+
+/* Buffers of one procedural mesh section, laid out the way CreateMeshSection takes them */
+struct PieceMeshData
+{
+	TArray<FVector> Vertices;
+	TArray<int32> Triangles;
+	TArray<FVector> Normals;
+	TArray<FVector2D> UVs;
+	TArray<FProcMeshTangent> Tangents;
+};
+
+struct SlabSettings
+{
+	float Thickness = 1.0f;						// Depth along Y, centered on the pane plane
+	FBox2D UVBounds = FBox2D(FVector2D::ZeroVector, FVector2D(1.0, 1.0));	// Area of the (x, z) plane mapped to UV 0..1
+};
+
+/**
+ * SlabMeshBuilder turns pieces into glass slabs: a front face at +Y, a back face at -Y and one flat-shaded quad per rim edge.
+ * Positions, normals, planar UVs and tangents are written in one pass into buffers sized once per section.
+ */
+class GLASSFRACTURE_API SlabMeshBuilder
+{
+public:
+	static int32 NumVertices(int32 NumPoints) { return 6 * NumPoints; }
+	static int32 NumIndices(int32 NumPoints) { return 6 * (NumPoints - 2) + 6 * NumPoints; }
+
+	/* One section holding the slabs of Pieces[Selected[k]] for every k; each buffer is allocated once */
+	static void BuildSection(TArrayView<const Piece* const> Pieces, TArrayView<const int32> Selected, const SlabSettings& Settings, PieceMeshData& OutMesh);
+
+	/* Writes the slab of Piece at the given offsets; the buffers must already hold NumVertices and NumIndices more entries there */
+	static void WriteSlab(const Piece& Piece, const SlabSettings& Settings, PieceMeshData& Mesh, int32 VertexOffset, int32 IndexOffset);
+};
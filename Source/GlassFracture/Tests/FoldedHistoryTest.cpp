@@ -0,0 +1,134 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassFracture/ShatterableGlass.h"
+#include "GlassFracture/FractureJob.h"
+#include "GlassFracture/PatternCells/FracturePatternAsset.h"
+#include "GlassFracture/VoronoiDiagram/PoissonDiskSampler.h"
+#include "GlassFracture/VoronoiDiagram/VoronoiGenerator.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	const FBox2D PaneBox(FVector2D(-1000.0, -1000.0), FVector2D(1000.0, 1000.0));
+
+	/* Spokes wedges around the origin, clockwise like compiled cells */
+	UFracturePatternAsset* MakeWedgePattern(int32 Spokes, float Radius)
+	{
+		UFracturePatternAsset* Pattern = NewObject<UFracturePatternAsset>(GetTransientPackage());
+		Pattern->CellOffsets.Add(0);
+		for (int32 s = 0; s < Spokes; ++s)
+		{
+			const FVector2f A = Radius * FVector2f(FMath::Cos(2.0f * PI * s / Spokes), FMath::Sin(2.0f * PI * s / Spokes));
+			const FVector2f B = Radius * FVector2f(FMath::Cos(2.0f * PI * (s + 1) / Spokes), FMath::Sin(2.0f * PI * (s + 1) / Spokes));
+			Pattern->CellVertices.Append({ FVector2f::ZeroVector, B, A });
+			Pattern->CellOffsets.Add(Pattern->CellVertices.Num());
+
+			FBox2D Bounds(ForceInit);
+			Bounds += FVector2D::ZeroVector;
+			Bounds += FVector2D(A);
+			Bounds += FVector2D(B);
+			Pattern->CellBounds.Add(Bounds);
+			Pattern->PatternBounds += Bounds;
+		}
+		Pattern->BuildConvexParts();
+		return Pattern;
+	}
+
+	/* The server's rounding of a hit, see QuantizeTenths */
+	FGlassFractureEvent MakeEvent(FRandomStream& Stream, int32 Index)
+	{
+		FGlassFractureEvent Event;
+		Event.LocalImpact = FVector(FMath::RoundToDouble(Stream.FRandRange(PaneBox.Min.X, PaneBox.Max.X) * 10.0) / 10.0, 3.7,
+			FMath::RoundToDouble(Stream.FRandRange(PaneBox.Min.Y, PaneBox.Max.Y) * 10.0) / 10.0);
+		Event.Seed = Stream.RandHelper(MAX_int32);
+		Event.Index = Index;
+		return Event;
+	}
+
+	TArray<Piece> ApplyHit(FractureJobInput& Input, const FGlassFractureEvent& Event)
+	{
+		Input.PatternLocation = Event.LocalImpact;
+		Input.ImpactCenter = FVector2D(Event.LocalImpact.X, Event.LocalImpact.Z);
+		FractureJobResult Result = FractureJob::Run(Input);
+		Input.bRebuildAllSections = false;
+		return MoveTemp(Result.OutsidePieces);
+	}
+
+	bool SamePieces(const TArray<Piece>& A, const TArray<Piece>& B)
+	{
+		if (A.Num() != B.Num())
+		{
+			return false;
+		}
+		for (int32 i = 0; i < A.Num(); ++i)
+		{
+			if (A[i].points != B[i].points)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGlassFoldedHistoryTest, "GlassFracture.Replication.FoldedHistory",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/* A dense pane hit far past MaxFractureEvents: replaying the folded impacts rebuilds it, and the snapshot always replicates */
+bool FGlassFoldedHistoryTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumHits = 160;
+
+	UFracturePatternAsset* Pattern = MakeWedgePattern(12, 150.0f);
+	Pattern->AddToRoot();
+
+	FRandomStream SiteStream(7);
+	const TArray<Point> Sites = PoissonDiskSampler::Sample(SiteStream, PaneBox, 1.0f, 10000);
+	FractureJobInput Input;
+	Input.IntactPieces = VoronoiGenerator::GenerateVoronoiCells(Sites,
+		FVector(PaneBox.Min.X, 0.0, PaneBox.Min.Y), FVector(PaneBox.Max.X, 0.0, PaneBox.Max.Y), EVoronoiBackend::Delaunay);
+	Input.ImpactRadius = 80.0f;
+	Input.PaneBounds = PaneBox;
+	Input.SectionTiles = 4;
+	Input.Pattern = Pattern;
+	const FractureJobInput Intact = Input;
+
+	// Live: every event is applied, then folded as the server does once it falls out of FractureEvents
+	FRandomStream HitStream(11);
+	FGlassFractureSnapshot Snapshot;
+	for (int32 i = 0; i < NumHits; ++i)
+	{
+		const FGlassFractureEvent Event = MakeEvent(HitStream, i);
+		Input.IntactPieces = ApplyHit(Input, Event);
+		Snapshot.Fold(Event);
+	}
+	TestTrue(TEXT("Hits broke the pane"), Input.IntactPieces.Num() < Intact.IntactPieces.Num());
+
+	// Late joiner: only the folded impacts
+	FractureJobInput Replay = Intact;
+	for (int32 i = 0; i < Snapshot.Impacts.Num(); ++i)
+	{
+		Replay.IntactPieces = ApplyHit(Replay, Snapshot.Unfold(i));
+	}
+	TestTrue(TEXT("Replayed pane matches the live one"), SamePieces(Replay.IntactPieces, Input.IntactPieces));
+
+	// The largest MaxFoldedImpacts still replicates, however dense the pane
+	const int32 MaxRepArraySize = IConsoleManager::Get().FindConsoleVariable(TEXT("net.MaxRepArraySize"))->GetInt();
+	const int32 MaxRepArrayMemory = IConsoleManager::Get().FindConsoleVariable(TEXT("net.MaxRepArrayMemory"))->GetInt();
+	FGlassFractureSnapshot Full;
+	for (int32 i = 0; i < 2048; ++i)
+	{
+		Full.Fold(MakeEvent(HitStream, i));
+	}
+	TestTrue(TEXT("Full snapshot is within net.MaxRepArraySize"), Full.Impacts.Num() <= MaxRepArraySize);
+	TestTrue(TEXT("Full snapshot is within net.MaxRepArrayMemory"), Full.Impacts.Num() * (int32)sizeof(FIntPoint) <= MaxRepArrayMemory);
+
+	Pattern->RemoveFromRoot();
+	return true;
+}
+
+#endif
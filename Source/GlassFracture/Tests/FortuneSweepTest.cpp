@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassFracture/VoronoiDiagram/FortuneSweep.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace
+{
+	double PieceArea(const Piece& Cell)
+	{
+		double TwiceArea = 0.0;
+		for (int32 i = 0; i < Cell.points.Num(); ++i)
+		{
+			const Point& P = Cell.points[i];
+			const Point& Q = Cell.points[(i + 1) % Cell.points.Num()];
+			TwiceArea += (double)P.x * Q.z - (double)Q.x * P.z;
+		}
+		return 0.5 * TwiceArea;
+	}
+
+	/* Every site gets one counter-clockwise cell and the cells tile the pane */
+	void TestTiling(FAutomationTestBase& Test, const FString& What, const TArray<Point>& Sites, float Size)
+	{
+		const TArray<Piece> Cells = FortuneSweep::GenerateVoronoiCells(Sites, FVector::ZeroVector, FVector(Size, 0.0f, Size));
+		Test.TestEqual(What + TEXT(": one cell per site"), Cells.Num(), Sites.Num());
+
+		double Area = 0.0;
+		int32 Flipped = 0;
+		for (const Piece& Cell : Cells)
+		{
+			const double CellArea = PieceArea(Cell);
+			Area += CellArea;
+			Flipped += (CellArea > 0.0) ? 0 : 1;
+		}
+		Test.TestEqual(What + TEXT(": cells cover the pane"), Area, (double)Size * Size, 1e-2);
+		Test.TestEqual(What + TEXT(": no cell is empty or flipped"), Flipped, 0);
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFortuneSweepSharedRowTest, "GlassFracture.FortuneSweep.SharedRow",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/* Sites on the first sweep row are appended to the beach line instead of splitting an arc */
+bool FFortuneSweepSharedRowTest::RunTest(const FString& Parameters)
+{
+	TArray<Point> Row;
+	for (int32 i = 0; i < 6; ++i) {
+		Row.Add(Point(5.0f + 15.0f * i, 10.0f));
+	}
+	TestTiling(*this, TEXT("Single row"), Row, 100.0f);
+
+	TArray<Point> RowAndAbove = Row;
+	RowAndAbove.Add(Point(40.0f, 60.0f));
+	RowAndAbove.Add(Point(12.5f, 35.0f));
+	TestTiling(*this, TEXT("Row with sites above"), RowAndAbove, 100.0f);
+
+	// Every row shared by several sites, with cocircular quadruples everywhere
+	TArray<Point> Grid;
+	for (int32 z = 0; z < 10; ++z) {
+		for (int32 x = 0; x < 10; ++x) {
+			Grid.Add(Point(5.0f + 10.0f * x, 5.0f + 10.0f * z));
+		}
+	}
+	TestTiling(*this, TEXT("Grid"), Grid, 100.0f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFortuneSweepRandomTest, "GlassFracture.FortuneSweep.Random",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FFortuneSweepRandomTest::RunTest(const FString& Parameters)
+{
+	FRandomStream Stream(7);
+	TArray<Point> Sites;
+	for (int32 i = 0; i < 2000; ++i) {
+		Sites.Add(Point(Stream.FRandRange(0.0f, 100.0f), Stream.FRandRange(0.0f, 100.0f)));
+	}
+	TestTiling(*this, TEXT("Random"), Sites, 100.0f);
+	return true;
+}
+
+#endif
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassFracture/GeometricPredicates.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeometricPredicatesOrient2DTest, "GlassFracture.GeometricPredicates.Orient2D",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/* Near-collinear triples where a plain double evaluation gets the sign wrong or disagrees with itself under permutation */
+bool FGeometricPredicatesOrient2DTest::RunTest(const FString& Parameters)
+{
+	const FVector2D B(12.0, 12.0);
+	const FVector2D C(24.0, 24.0);
+
+	TestEqual(TEXT("Collinear points give exactly zero"), GeometricPredicates::Orient2D(FVector2D(0.5, 0.5), B, C), 0.0);
+	TestEqual(TEXT("Far collinear points give exactly zero"),
+		GeometricPredicates::Orient2D(FVector2D(0.5, 0.25), FVector2D(1.5, 0.75), FVector2D(1e10 + 0.5, 5e9 + 0.25)), 0.0);
+
+	TestTrue(TEXT("One ulp above the line turns counter-clockwise"),
+		GeometricPredicates::Orient2D(FVector2D(0.5, 0.5), B, FVector2D(24.0, std::nextafter(24.0, 25.0))) > 0.0);
+	TestTrue(TEXT("One ulp below the line turns clockwise"),
+		GeometricPredicates::Orient2D(FVector2D(0.5, 0.5), B, FVector2D(24.0, std::nextafter(24.0, 23.0))) < 0.0);
+
+	// Shewchuk's grid: A walks a 32 x 32 ulp neighbourhood of (0.5, 0.5); the sign has to follow the line and survive permutation
+	int32 Inconsistent = 0;
+	int32 WrongSide = 0;
+	for (int32 i = 0; i < 32; ++i)
+	{
+		for (int32 j = 0; j < 32; ++j)
+		{
+			const FVector2D A(0.5 + i * DBL_EPSILON, 0.5 + j * DBL_EPSILON);
+			const double Sign = FMath::Sign(GeometricPredicates::Orient2D(A, B, C));
+			if (Sign != FMath::Sign(GeometricPredicates::Orient2D(B, C, A)) || Sign != -FMath::Sign(GeometricPredicates::Orient2D(B, A, C)))
+			{
+				Inconsistent++;
+			}
+			// A is left of B -> C exactly when it lies above the diagonal, i.e. j > i
+			if (Sign != (double)FMath::Sign(j - i))
+			{
+				WrongSide++;
+			}
+		}
+	}
+	TestEqual(TEXT("Permuted orientations agree"), Inconsistent, 0);
+	TestEqual(TEXT("Orientation matches the exact side"), WrongSide, 0);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeometricPredicatesInCircleTest, "GlassFracture.GeometricPredicates.InCircle",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FGeometricPredicatesInCircleTest::RunTest(const FString& Parameters)
+{
+	// Counter-clockwise on a circle of radius R around a far-off center; every coordinate is exact
+	const double R = 1024.0;
+	const FVector2D Center(1e8, -1e8);
+	const FVector2D A = Center + FVector2D(R, 0.0);
+	const FVector2D B = Center + FVector2D(0.0, R);
+	const FVector2D C = Center + FVector2D(-R, 0.0);
+	const FVector2D OnCircle = Center + FVector2D(0.0, -R);
+
+	TestEqual(TEXT("Cocircular point gives exactly zero"), GeometricPredicates::InCircle(A, B, C, OnCircle), 0.0);
+	TestTrue(TEXT("One ulp inside is inside"),
+		GeometricPredicates::InCircle(A, B, C, FVector2D(OnCircle.X, std::nextafter(OnCircle.Y, Center.Y))) > 0.0);
+	TestTrue(TEXT("One ulp outside is outside"),
+		GeometricPredicates::InCircle(A, B, C, FVector2D(OnCircle.X, std::nextafter(OnCircle.Y, -1e9))) < 0.0);
+	TestTrue(TEXT("Sign flips with the triangle's winding"),
+		GeometricPredicates::InCircle(C, B, A, FVector2D(OnCircle.X, std::nextafter(OnCircle.Y, Center.Y))) < 0.0);
+
+	TestEqual(TEXT("Point on the disk boundary gives exactly zero"), GeometricPredicates::InDisk(OnCircle, Center, R), 0.0);
+	TestTrue(TEXT("One ulp inside the disk is inside"),
+		GeometricPredicates::InDisk(FVector2D(OnCircle.X, std::nextafter(OnCircle.Y, Center.Y)), Center, R) > 0.0);
+	return true;
+}
+
+#endif
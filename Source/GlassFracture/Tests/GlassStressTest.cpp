@@ -0,0 +1,112 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassFracture/GlassStressHarness.h"
+#include "GlassFracture/GlassFracture.h"
+#include "GlassFracture/ShatterableGlass.h"
+#include "Misc/AutomationTest.h"
+#include "Tests/AutomationCommon.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+static TAutoConsoleVariable<FString> CVarStressTestMap(
+	TEXT("glass.Stress.TestMap"), TEXT("/Engine/Maps/Entry"),
+	TEXT("Map the stress automation test opens; the harness spawns its own panes, so any map works."));
+
+static TAutoConsoleVariable<FString> CVarStressTestPaneClass(
+	TEXT("glass.Stress.TestPaneClass"), TEXT(""),
+	TEXT("Pane blueprint class path for the stress automation test, empty for the plain AShatterableGlass."));
+
+namespace
+{
+	UWorld* FindGameWorld()
+	{
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			if ((Context.WorldType == EWorldType::Game || Context.WorldType == EWorldType::PIE) && Context.World())
+			{
+				return Context.World();
+			}
+		}
+		return nullptr;
+	}
+
+	/* Spawns the harness once the map is up, then fails the test on a timeout or a blown budget */
+	class FRunStressHarnessCommand : public IAutomationLatentCommand
+	{
+	public:
+		FRunStressHarnessCommand(FAutomationTestBase* InTest, double InTimeoutSeconds)
+			: Test(InTest), TimeoutSeconds(InTimeoutSeconds)
+		{
+		}
+
+		virtual bool Update() override
+		{
+			if (GetCurrentRunTime() > TimeoutSeconds)
+			{
+				Test->AddError(FString::Printf(TEXT("Stress run did not finish within %.0f s"), TimeoutSeconds));
+				return true;
+			}
+
+			if (!Harness.IsValid())
+			{
+				UWorld* World = FindGameWorld();
+				if (!World || !World->HasBegunPlay())
+				{
+					return false;
+				}
+				AGlassStressHarness* NewHarness = World->SpawnActorDeferred<AGlassStressHarness>(AGlassStressHarness::StaticClass(), FTransform::Identity);
+				const FString ClassPath = CVarStressTestPaneClass.GetValueOnGameThread();
+				if (!ClassPath.IsEmpty())
+				{
+					if (UClass* PaneClass = LoadClass<AShatterableGlass>(nullptr, *ClassPath))
+					{
+						NewHarness->PaneClass = PaneClass;
+					}
+					else
+					{
+						Test->AddWarning(FString::Printf(TEXT("%s is not a glass pane class, using the default"), *ClassPath));
+					}
+				}
+				NewHarness->bRunOnBeginPlay = true;
+				NewHarness->bQuitWhenDone = false;
+				NewHarness->FinishSpawning(FTransform::Identity);
+				Harness = NewHarness;
+				return false;
+			}
+
+			if (!Harness->IsDone())
+			{
+				return false;
+			}
+
+			FString Failure;
+			if (!Harness->CheckBudgets(Failure))
+			{
+				Test->AddError(FString::Printf(TEXT("Stress run over budget: %s"), *Failure));
+			}
+			Harness->Destroy();
+			return true;
+		}
+
+	private:
+		FAutomationTestBase* Test;
+		double TimeoutSeconds;
+		TWeakObjectPtr<AGlassStressHarness> Harness;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGlassStressMassDestructionTest, "GlassFracture.Stress.MassDestruction",
+	EAutomationTestFlags::ClientContext | EAutomationTestFlags::ProductFilter)
+
+/* The harness defaults: 100 panes, 10 volleys of 10 hits, frame and physics p99 budgets */
+bool FGlassStressMassDestructionTest::RunTest(const FString& Parameters)
+{
+	AutomationOpenMap(CVarStressTestMap.GetValueOnGameThread());
+	ADD_LATENT_AUTOMATION_COMMAND(FRunStressHarnessCommand(this, 120.0));
+	return true;
+}
+
+#endif
@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassFracture/PolygonClipper.h"
+#include "Misc/AutomationTest.h"
+#include <cmath>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonClipperExactSideTest, "GlassFracture.PolygonClipper.ExactSide",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPolygonClipperExactSideTest::RunTest(const FString& Parameters)
+{
+	const Point Start(0.0f, 0.0f);
+	const Point End(4096.0f, 4096.0f);
+
+	TestEqual(TEXT("A vertex on the edge is exactly on it"), PolygonClipper::ExactSide(1.5f, 1.5f, Start, End), 0.0f);
+	TestEqual(TEXT("A vertex on the edge's extension is exactly on it"), PolygonClipper::ExactSide(-8192.0f, -8192.0f, Start, End), 0.0f);
+
+	// One float ulp off a long edge
+	const float Far = 3000.0f;
+	TestTrue(TEXT("One ulp left of the edge is left"), PolygonClipper::ExactSide(Far, std::nextafter(Far, 4000.0f), Start, End) > 0.0f);
+	TestTrue(TEXT("One ulp right of the edge is right"), PolygonClipper::ExactSide(Far, std::nextafter(Far, 2000.0f), Start, End) < 0.0f);
+
+	// Results too small for a float keep their sign
+	const Point TinyEnd(1e-30f, 1e-30f);
+	TestTrue(TEXT("A sub-float side keeps its sign"), PolygonClipper::ExactSide(1e-30f, 2e-30f, Start, TinyEnd) > 0.0f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPolygonClipperSharedEdgeTest, "GlassFracture.PolygonClipper.SharedEdge",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/* A subject touching a cell only along an edge must not come back as a zero-area sliver */
+bool FPolygonClipperSharedEdgeTest::RunTest(const FString& Parameters)
+{
+	// Unit square, counter-clockwise, with an extra vertex in the middle of its right edge
+	const TArray<Point> Subject = { Point(0.0f, 0.0f), Point(1.0f, 0.0f), Point(1.0f, 0.5f), Point(1.0f, 1.0f), Point(0.0f, 1.0f) };
+
+	// Clip cells are clockwise
+	const TArray<Point> RightCell = { Point(1.0f, 0.0f), Point(1.0f, 1.0f), Point(2.0f, 1.0f), Point(2.0f, 0.0f) };
+	const TArray<Point> OverlappingCell = { Point(0.5f, 0.0f), Point(0.5f, 1.0f), Point(2.0f, 1.0f), Point(2.0f, 0.0f) };
+
+	TestEqual(TEXT("Touching along an edge clips to nothing"), PolygonClipper::PerformClipping(Subject, RightCell).Num(), 0);
+
+	const TArray<Point> Overlap = PolygonClipper::PerformClipping(Subject, OverlappingCell);
+	TestTrue(TEXT("A real overlap is kept"), Overlap.Num() >= 3);
+	double TwiceArea = 0.0;
+	for (int32 i = 0; i < Overlap.Num(); ++i)
+	{
+		const Point& P = Overlap[i];
+		const Point& Q = Overlap[(i + 1) % Overlap.Num()];
+		TwiceArea += (double)P.x * Q.z - (double)Q.x * P.z;
+	}
+	TestEqual(TEXT("The overlap is the right half of the square"), FMath::Abs(TwiceArea) * 0.5, 0.5, 1e-6);
+	return true;
+}
+
+#endif
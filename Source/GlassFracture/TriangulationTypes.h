@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "GeometricPredicates.h"
 
 struct Point
 {
@@ -48,9 +49,7 @@ struct Circle
 		: center(_center), radius(_radius) {}
 
 	bool contains(const Point& point) const {
-		float dx = center.x - point.x;
-		float dz = center.z - point.z;
-		return (std::sqrt(dx * dx + dz * dz) <= radius);
+		return GeometricPredicates::InDisk(FVector2D(point.x, point.z), FVector2D(center.x, center.z), radius) >= 0.0;
 	}
 };
 
@@ -60,16 +59,30 @@ struct Piece
 {
 	TArray<Point> points;
 	TArray<Edge> edges;
+	FBox2D bounds;
 
 	Piece(const TArray<Edge>& _edges, const TArray<Point>& _points)
-		: points(_points), edges(_edges) {}
+		: points(_points), edges(_edges), bounds(calcBounds(_points)) {}
 
-	Piece(const TArray<Point>& _points) : points(_points)
+	Piece(const TArray<Point>& _points) : Piece(TArrayView<const Point>(_points)) {}
+
+	/* Copies the points once, e.g. straight out of a clip batch */
+	Piece(TArrayView<const Point> _points) : points(_points), bounds(calcBounds(points))
 	{
+		edges.Reserve(points.Num());
 		for (int32 i = 0; i < points.Num(); i++) {
 			edges.Add(Edge(points[i], points[(i + 1) % points.Num()]));
 		}
 	}
+
+	static FBox2D calcBounds(const TArray<Point>& _points)
+	{
+		FBox2D box(ForceInit);
+		for (const Point& point : _points) {
+			box += FVector2D(point.x, point.z);
+		}
+		return box;
+	}
 };
 
 struct Triangle
@@ -125,7 +138,11 @@ struct Triangle
 		return Circle(center, radius);
 	}
 
+	// Exact test against the vertices rather than the rounded circumcircle; either winding is accepted
 	bool inCircumcircle(const Point& v) const {
-		return c.contains(v);
+		const FVector2D a(v0.x, v0.z), b(v1.x, v1.z), d(v2.x, v2.z), p(v.x, v.z);
+		double orientation = GeometricPredicates::Orient2D(a, b, d);
+		double incircle = GeometricPredicates::InCircle(a, b, d, p);
+		return orientation > 0.0 ? incircle >= 0.0 : (orientation < 0.0 ? incircle <= 0.0 : c.contains(v));
 	}
 };
\ No newline at end of file
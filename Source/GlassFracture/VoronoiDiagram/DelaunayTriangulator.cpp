@@ -2,37 +2,100 @@
 
 
 #include "DelaunayTriangulator.h"
+#include "GlassFracture/GeometricPredicates.h"
+
+namespace
+{
+	/* Position of (x, y) along a Hilbert curve filling a 2^16 x 2^16 grid */
+	uint64 HilbertIndex(uint32 x, uint32 y)
+	{
+		const uint32 n = 1u << 16;
+		uint64 d = 0;
+
+		for (uint32 s = n >> 1; s > 0; s >>= 1) {
+			uint32 rx = (x & s) > 0;
+			uint32 ry = (y & s) > 0;
+			d += (uint64)s * s * ((3 * rx) ^ ry);
+
+			if (ry == 0) {
+				if (rx == 1) {
+					x = n - 1 - x;
+					y = n - 1 - y;
+				}
+				Swap(x, y);
+			}
+		}
+		return d;
+	}
+}
 
 TArray<Triangle> DelaunayTriangulator::ComputeTriangulation(const TArray<Point>& PointList)
 {
 	TArray<Triangle> Triangulation;
 
-	// Step 1: Add super-triangle (bounding triangle large enough to contain all points)
-	Triangle st = MakeSuperTriangle(PointList);
-	Triangulation.Add(st);
+	if (PointList.Num() < 3) {
+		return Triangulation;
+	}
 
-	// Step 2: Triangulate each vertex
+	MeshState Mesh;
+
+	// Step 1: Add super-triangle (bounding triangle large enough to contain all points)
+	Mesh.Vertices.Reserve(PointList.Num() + 3);
+	MakeSuperTriangle(PointList, Mesh.Vertices);
 	for (const Point& point : PointList) {
-		AddPoint(point, Triangulation);
+		Mesh.Vertices.Add(FVector2D(point.x, point.z));
 	}
 
-	// Step 3: Remove triangles that share edges with super-triangle
-	Triangulation.RemoveAll([&st](const Triangle& triangle) {
-		return (triangle.v0 == st.v0 || triangle.v0 == st.v1 || triangle.v0 == st.v2 ||
-				triangle.v1 == st.v0 || triangle.v1 == st.v1 || triangle.v1 == st.v2 ||
-				triangle.v2 == st.v0 || triangle.v2 == st.v1 || triangle.v2 == st.v2);
-		});
+	Mesh.Triangles.Reserve(2 * PointList.Num() + 1);
+	Mesh.Triangles.Add({ { 0, 1, 2 }, { INDEX_NONE, INDEX_NONE, INDEX_NONE }, true });
+	Mesh.CavityMarks.Add(0);
+	Mesh.TriangleByStart.Init(INDEX_NONE, Mesh.Vertices.Num());
+
+	// Step 2: Triangulate each vertex, in Hilbert order so that consecutive walks stay short
+	for (int32 index : SortByHilbertCurve(PointList)) {
+		AddPoint(index + 3, Mesh);
+	}
+
+	// Step 3: Remove triangles that share a vertex with the super-triangle
+	Triangulation.Reserve(Mesh.Triangles.Num());
+	for (const MeshTriangle& tri : Mesh.Triangles) {
+		if (!tri.bAlive || tri.V[0] < 3 || tri.V[1] < 3 || tri.V[2] < 3) {
+			continue;
+		}
+		Triangulation.Add(Triangle(PointList[tri.V[0] - 3], PointList[tri.V[1] - 3], PointList[tri.V[2] - 3]));
+	}
 
 	return Triangulation;
 }
 
-Triangle DelaunayTriangulator::MakeSuperTriangle(const TArray<Point>& pointList)
+void DelaunayTriangulator::MakeSuperTriangle(const TArray<Point>& pointList, TArray<FVector2D>& Vertices)
 {
 	double minx = std::numeric_limits<double>::infinity();
 	double minz = std::numeric_limits<double>::infinity();
 	double maxx = -std::numeric_limits<double>::infinity();
 	double maxz = -std::numeric_limits<double>::infinity();
 
+	for (const Point& point : pointList) {
+		minx = FMath::Min(minx, (double)point.x);
+		minz = FMath::Min(minz, (double)point.z);
+		maxx = FMath::Max(maxx, (double)point.x);
+		maxz = FMath::Max(maxz, (double)point.z);
+	}
+
+	double dx = FMath::Max((maxx - minx) * 10, 1.0);
+	double dz = FMath::Max((maxz - minz) * 10, 1.0);
+
+	// Counter-clockwise order
+	Vertices.Add(FVector2D(minx - dx, minz - dz * 3));
+	Vertices.Add(FVector2D(maxx + dx * 3, maxz + dz));
+	Vertices.Add(FVector2D(minx - dx, maxz + dz));
+}
+
+TArray<int32> DelaunayTriangulator::SortByHilbertCurve(const TArray<Point>& pointList)
+{
+	float minx = TNumericLimits<float>::Max(), minz = TNumericLimits<float>::Max();
+	float maxx = TNumericLimits<float>::Lowest(), maxz = TNumericLimits<float>::Lowest();
+
 	for (const Point& point : pointList) {
 		minx = FMath::Min(minx, point.x);
 		minz = FMath::Min(minz, point.z);
@@ -40,53 +103,165 @@ Triangle DelaunayTriangulator::MakeSuperTriangle(const TArray<Point>& pointList)
 		maxz = FMath::Max(maxz, point.z);
 	}
 
-	double dx = (maxx - minx) * 10;
-	double dz = (maxz - minz) * 10;
+	const double scale = 65535.0 / FMath::Max(FMath::Max(maxx - minx, maxz - minz), KINDA_SMALL_NUMBER);
+
+	TArray<uint64> keys;
+	TArray<int32> order;
+	keys.SetNumUninitialized(pointList.Num());
+	order.SetNumUninitialized(pointList.Num());
+
+	for (int32 i = 0; i < pointList.Num(); ++i) {
+		uint32 gx = (uint32)((pointList[i].x - minx) * scale);
+		uint32 gz = (uint32)((pointList[i].z - minz) * scale);
+		keys[i] = HilbertIndex(gx, gz);
+		order[i] = i;
+	}
 
-	Point v0(minx - dx, minz - dz * 3);
-	Point v1(minx - dx, maxz + dz);
-	Point v2(maxx + dx * 3, maxz + dz);
+	order.Sort([&keys](int32 A, int32 B) {
+		return keys[A] < keys[B];
+	});
 
-	return Triangle(v0, v1, v2);
+	return order;
 }
 
-void DelaunayTriangulator::AddPoint(const Point& point, TArray<Triangle>& triangulation)
+/* Visibility walk from the most recently created triangle towards P */
+int32 DelaunayTriangulator::LocateTriangle(const MeshState& Mesh, const FVector2D& P)
 {
-	TArray<Edge> edges;
-
-	triangulation.RemoveAll([&](const Triangle& triangle) {
-		if (triangle.inCircumcircle(point)) {
-			edges.Add(Edge(triangle.v0, triangle.v1));
-			edges.Add(Edge(triangle.v1, triangle.v2));
-			edges.Add(Edge(triangle.v2, triangle.v0));
-			return true;
+	int32 current = Mesh.LastTriangle;
+	const int32 maxSteps = Mesh.Triangles.Num();
+
+	for (int32 step = 0; step < maxSteps; ++step) {
+		const MeshTriangle& tri = Mesh.Triangles[current];
+		int32 next = current;
+
+		// Rotate the starting edge so the walk cannot cycle on degenerate input
+		for (int32 k = 0; k < 3; ++k) {
+			int32 i = (k + step) % 3;
+			const FVector2D& a = Mesh.Vertices[tri.V[(i + 1) % 3]];
+			const FVector2D& b = Mesh.Vertices[tri.V[(i + 2) % 3]];
+
+			if (GeometricPredicates::Orient2D(a, b, P) < 0.0) {
+				next = tri.N[i];
+				break;
+			}
 		}
-		return false;
-		});
 
-	edges = UniqueEdges(edges);
+		if (next == current) {
+			return current;
+		}
+		if (next == INDEX_NONE) {
+			return INDEX_NONE;
+		}
+		current = next;
+	}
 
-	for (const Edge& edge : edges) {
-		triangulation.Add(Triangle(edge.v0, edge.v1, point));
+	// Walk did not converge, fall back to a linear scan
+	for (int32 t = 0; t < Mesh.Triangles.Num(); ++t) {
+		const MeshTriangle& tri = Mesh.Triangles[t];
+		if (tri.bAlive
+			&& GeometricPredicates::Orient2D(Mesh.Vertices[tri.V[0]], Mesh.Vertices[tri.V[1]], P) >= 0.0
+			&& GeometricPredicates::Orient2D(Mesh.Vertices[tri.V[1]], Mesh.Vertices[tri.V[2]], P) >= 0.0
+			&& GeometricPredicates::Orient2D(Mesh.Vertices[tri.V[2]], Mesh.Vertices[tri.V[0]], P) >= 0.0) {
+			return t;
+		}
 	}
+	return INDEX_NONE;
 }
 
-TArray<Edge> DelaunayTriangulator::UniqueEdges(const TArray<Edge>& edges)
+void DelaunayTriangulator::AddPoint(int32 VertexIndex, MeshState& Mesh)
 {
-	TArray<Edge> uniqueEdges;
+	const FVector2D& P = Mesh.Vertices[VertexIndex];
 
-	for (size_t i = 0; i < edges.Num(); ++i) {
-		bool isUnique = true;
-		for (size_t j = 0; j < edges.Num(); ++j) {
-			if (i != j && edges[i] == edges[j]) {
-				isUnique = false;
-				break;
+	int32 start = LocateTriangle(Mesh, P);
+	if (start == INDEX_NONE) {
+		return;
+	}
+
+	// Skip duplicate sites
+	for (int32 k = 0; k < 3; ++k) {
+		if (Mesh.Vertices[Mesh.Triangles[start].V[k]] == P) {
+			return;
+		}
+	}
+
+	// Flood-fill the cavity of triangles whose circumcircle contains P
+	const int32 stamp = ++Mesh.Stamp;
+	Mesh.Cavity.Reset();
+	Mesh.Stack.Reset();
+
+	Mesh.CavityMarks[start] = stamp;
+	Mesh.Cavity.Add(start);
+	Mesh.Stack.Add(start);
+
+	while (Mesh.Stack.Num() > 0) {
+		const MeshTriangle& tri = Mesh.Triangles[Mesh.Stack.Pop(false)];
+
+		for (int32 i = 0; i < 3; ++i) {
+			int32 n = tri.N[i];
+			if (n == INDEX_NONE || Mesh.CavityMarks[n] == stamp) {
+				continue;
+			}
+			const MeshTriangle& neighbor = Mesh.Triangles[n];
+			if (GeometricPredicates::InCircle(Mesh.Vertices[neighbor.V[0]], Mesh.Vertices[neighbor.V[1]], Mesh.Vertices[neighbor.V[2]], P) > 0.0) {
+				Mesh.CavityMarks[n] = stamp;
+				Mesh.Cavity.Add(n);
+				Mesh.Stack.Add(n);
 			}
 		}
-		if (isUnique) {
-			uniqueEdges.Add(edges[i]);
+	}
+
+	// Collect the cavity boundary in counter-clockwise order per edge
+	Mesh.Boundary.Reset();
+	for (int32 t : Mesh.Cavity) {
+		const MeshTriangle& tri = Mesh.Triangles[t];
+		for (int32 i = 0; i < 3; ++i) {
+			int32 n = tri.N[i];
+			if (n == INDEX_NONE || Mesh.CavityMarks[n] != stamp) {
+				Mesh.Boundary.Add({ tri.V[(i + 1) % 3], tri.V[(i + 2) % 3], n });
+			}
 		}
 	}
 
-	return uniqueEdges;
+	for (int32 t : Mesh.Cavity) {
+		Mesh.Triangles[t].bAlive = false;
+		Mesh.FreeTriangles.Add(t);
+	}
+
+	// Re-triangulate the cavity as a fan around P
+	Mesh.NewTriangles.Reset();
+	for (const CavityEdge& edge : Mesh.Boundary) {
+		int32 t = AllocateTriangle(Mesh);
+		Mesh.Triangles[t] = { { VertexIndex, edge.A, edge.B }, { edge.Outer, INDEX_NONE, INDEX_NONE }, true };
+		Mesh.TriangleByStart[edge.A] = t;
+		Mesh.NewTriangles.Add(t);
+
+		if (edge.Outer != INDEX_NONE) {
+			MeshTriangle& outer = Mesh.Triangles[edge.Outer];
+			for (int32 k = 0; k < 3; ++k) {
+				if (outer.V[(k + 1) % 3] == edge.B && outer.V[(k + 2) % 3] == edge.A) {
+					outer.N[k] = t;
+					break;
+				}
+			}
+		}
+	}
+
+	// Link the fan: edge (B, P) is shared with the triangle starting at B, edge (P, A) with the one ending at A
+	for (int32 t : Mesh.NewTriangles) {
+		MeshTriangle& tri = Mesh.Triangles[t];
+		int32 next = Mesh.TriangleByStart[tri.V[2]];
+		tri.N[1] = next;
+		Mesh.Triangles[next].N[2] = t;
+	}
+
+	Mesh.LastTriangle = Mesh.NewTriangles.Last();
+}
+
+int32 DelaunayTriangulator::AllocateTriangle(MeshState& Mesh)
+{
+	if (Mesh.FreeTriangles.Num() > 0) {
+		return Mesh.FreeTriangles.Pop(false);
+	}
+	Mesh.CavityMarks.Add(0);
+	return Mesh.Triangles.AddUninitialized();
 }
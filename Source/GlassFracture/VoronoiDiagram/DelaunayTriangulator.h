@@ -7,6 +7,8 @@
 
 /**
  * DelaunayTriangulator is a utility class for computing Delaunay triangulation based on the Bowyer-Watson algorithm.
+ * Triangles are kept in an index-based mesh with neighbor links, so each insertion only walks to the containing
+ * triangle and flood-fills its cavity instead of scanning the whole triangulation.
  */
 class GLASSFRACTURE_API DelaunayTriangulator
 {
@@ -14,7 +16,41 @@ public:
 	static TArray<Triangle> ComputeTriangulation(const TArray<Point>& PointList);
 
 private:
-	static Triangle MakeSuperTriangle(const TArray<Point>& pointList);
-	static void AddPoint(const Point& point, TArray<Triangle>& triangulation);
-	static TArray<Edge> UniqueEdges(const TArray<Edge>& edges);
+	struct MeshTriangle
+	{
+		int32 V[3];		// Vertex indices in counter-clockwise order
+		int32 N[3];		// N[i] is the neighbor across the edge opposite V[i], INDEX_NONE on the hull
+		bool bAlive;
+	};
+
+	struct CavityEdge
+	{
+		int32 A;
+		int32 B;
+		int32 Outer;
+	};
+
+	struct MeshState
+	{
+		TArray<FVector2D> Vertices;
+		TArray<MeshTriangle> Triangles;
+		TArray<int32> FreeTriangles;
+		TArray<int32> CavityMarks;
+
+		// Scratch buffers reused across insertions
+		TArray<int32> Cavity;
+		TArray<int32> Stack;
+		TArray<CavityEdge> Boundary;
+		TArray<int32> NewTriangles;
+		TArray<int32> TriangleByStart;
+
+		int32 LastTriangle = 0;
+		int32 Stamp = 0;
+	};
+
+	static void MakeSuperTriangle(const TArray<Point>& pointList, TArray<FVector2D>& Vertices);
+	static TArray<int32> SortByHilbertCurve(const TArray<Point>& pointList);
+	static int32 LocateTriangle(const MeshState& Mesh, const FVector2D& P);
+	static void AddPoint(int32 VertexIndex, MeshState& Mesh);
+	static int32 AllocateTriangle(MeshState& Mesh);
 };
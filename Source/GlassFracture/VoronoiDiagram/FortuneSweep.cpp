@@ -0,0 +1,396 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FortuneSweep.h"
+#include "GlassFracture/GeometricPredicates.h"
+
+namespace
+{
+	struct CircleEventOrder
+	{
+		template <typename EventType>
+		bool operator()(const EventType& A, const EventType& B) const
+		{
+			return A.Y < B.Y || (A.Y == B.Y && A.X < B.X);
+		}
+	};
+}
+
+/* Fortune's algorithm with the sweep line moving towards +Z */
+TArray<Piece> FortuneSweep::GenerateVoronoiCells(const TArray<Point>& Sites, const FVector& LocalMinBound, const FVector& LocalMaxBound)
+{
+	TArray<Piece> VoronoiPieces;
+
+	SweepState State;
+	State.Sites.Reserve(Sites.Num());
+	for (const Point& Site : Sites) {
+		State.Sites.Add(FVector2D(Site.x, Site.z));
+	}
+	State.Neighbors.SetNum(Sites.Num());
+	State.Arcs.Reserve(2 * Sites.Num());
+
+	// Site events in sweep order, coincident sites are dropped
+	TArray<int32> SiteOrder;
+	SiteOrder.Reserve(Sites.Num());
+	for (int32 i = 0; i < Sites.Num(); ++i) {
+		SiteOrder.Add(i);
+	}
+	SiteOrder.Sort([&State](int32 A, int32 B) {
+		const FVector2D& SA = State.Sites[A];
+		const FVector2D& SB = State.Sites[B];
+		return SA.Y < SB.Y || (SA.Y == SB.Y && SA.X < SB.X);
+	});
+
+	TArray<bool> Dropped;
+	Dropped.Init(false, Sites.Num());
+
+	int32 NextSite = 0;
+	while (NextSite < SiteOrder.Num() || State.Events.Num() > 0)
+	{
+		bool bSiteEvent = NextSite < SiteOrder.Num()
+			&& (State.Events.Num() == 0 || State.Sites[SiteOrder[NextSite]].Y <= State.Events.HeapTop().Y);
+
+		if (bSiteEvent)
+		{
+			int32 SiteIndex = SiteOrder[NextSite++];
+			if (NextSite > 1 && State.Sites[SiteIndex] == State.Sites[SiteOrder[NextSite - 2]]) {
+				Dropped[SiteIndex] = true;
+				continue;
+			}
+			HandleSiteEvent(SiteIndex, State);
+		}
+		else
+		{
+			CircleEvent Event;
+			State.Events.HeapPop(Event, CircleEventOrder(), false);
+			if (State.Arcs[Event.Arc].EventId == Event.Id) {
+				HandleCircleEvent(Event, State);
+			}
+		}
+	}
+
+	// Cut each cell out of the pane rectangle with the bisectors of its neighbors
+	TArray<FVector2D> Polygon;
+	TArray<FVector2D> Scratch;
+
+	for (int32 i = 0; i < State.Sites.Num(); ++i)
+	{
+		if (Dropped[i]) {
+			continue;
+		}
+
+		Polygon.Reset();
+		Polygon.Add(FVector2D(LocalMinBound.X, LocalMinBound.Z));	// Bottom-Left
+		Polygon.Add(FVector2D(LocalMaxBound.X, LocalMinBound.Z));	// Bottom-Right
+		Polygon.Add(FVector2D(LocalMaxBound.X, LocalMaxBound.Z));	// Top-Right
+		Polygon.Add(FVector2D(LocalMinBound.X, LocalMaxBound.Z));	// Top-Left
+
+		for (int32 Neighbor : State.Neighbors[i]) {
+			ClipToBisector(State.Sites[i], State.Sites[Neighbor], Polygon, Scratch);
+			if (Polygon.Num() < 3) {
+				break;
+			}
+		}
+
+		double TwiceArea = 0.0;
+		for (int32 j = 0; j < Polygon.Num(); ++j) {
+			TwiceArea += FVector2D::CrossProduct(Polygon[j], Polygon[(j + 1) % Polygon.Num()]);
+		}
+
+		// Sites just outside the pane can leave a cell that only touches its border
+		if (Polygon.Num() > 2 && TwiceArea > KINDA_SMALL_NUMBER)
+		{
+			TArray<Point> CellPoints;
+			CellPoints.Reserve(Polygon.Num());
+			for (const FVector2D& V : Polygon) {
+				CellPoints.Add(Point(V.X, V.Y));
+			}
+			VoronoiPieces.Add(Piece(CellPoints));
+		}
+	}
+
+	return VoronoiPieces;
+}
+
+void FortuneSweep::HandleSiteEvent(int32 SiteIndex, SweepState& State)
+{
+	const FVector2D& P = State.Sites[SiteIndex];
+
+	if (State.Root == INDEX_NONE) {
+		State.Root = AddArc(SiteIndex, State);
+		return;
+	}
+
+	int32 Above = FindArcAbove(P, State);
+	int32 AboveSite = State.Arcs[Above].Site;
+
+	// Sites on the first sweep row have no arc to split yet
+	if (State.Sites[AboveSite].Y == P.Y)
+	{
+		int32 NewArc = AddArc(SiteIndex, State);
+		int32 OldNext = State.Arcs[Above].Next;
+
+		State.Arcs[Above].Next = NewArc;
+		State.Arcs[NewArc].Prev = Above;
+		State.Arcs[NewArc].Next = OldNext;
+		if (OldNext != INDEX_NONE) {
+			State.Arcs[OldNext].Prev = NewArc;
+		}
+		InsertArcAfter(Above, NewArc, State);
+
+		AddNeighbors(AboveSite, SiteIndex, State);
+		return;
+	}
+
+	// Split the arc above into (Above, NewArc, RightArc)
+	State.Arcs[Above].EventId = INDEX_NONE;
+
+	int32 NewArc = AddArc(SiteIndex, State);
+	int32 RightArc = AddArc(AboveSite, State);
+	int32 OldNext = State.Arcs[Above].Next;
+
+	State.Arcs[Above].Next = NewArc;
+	State.Arcs[NewArc].Prev = Above;
+	State.Arcs[NewArc].Next = RightArc;
+	State.Arcs[RightArc].Prev = NewArc;
+	State.Arcs[RightArc].Next = OldNext;
+	if (OldNext != INDEX_NONE) {
+		State.Arcs[OldNext].Prev = RightArc;
+	}
+	InsertArcAfter(Above, NewArc, State);
+	InsertArcAfter(NewArc, RightArc, State);
+
+	AddNeighbors(AboveSite, SiteIndex, State);
+
+	CheckCircleEvent(Above, State);
+	CheckCircleEvent(RightArc, State);
+}
+
+void FortuneSweep::HandleCircleEvent(const CircleEvent& Event, SweepState& State)
+{
+	const Arc Vanishing = State.Arcs[Event.Arc];
+
+	AddNeighbors(State.Arcs[Vanishing.Prev].Site, State.Arcs[Vanishing.Next].Site, State);
+
+	State.Arcs[Vanishing.Prev].Next = Vanishing.Next;
+	State.Arcs[Vanishing.Next].Prev = Vanishing.Prev;
+	State.Arcs[Event.Arc].EventId = INDEX_NONE;
+	RemoveArc(Event.Arc, State);
+
+	CheckCircleEvent(Vanishing.Prev, State);
+	CheckCircleEvent(Vanishing.Next, State);
+}
+
+void FortuneSweep::CheckCircleEvent(int32 ArcIndex, SweepState& State)
+{
+	Arc& Middle = State.Arcs[ArcIndex];
+	Middle.EventId = INDEX_NONE;
+
+	if (Middle.Prev == INDEX_NONE || Middle.Next == INDEX_NONE) {
+		return;
+	}
+
+	int32 LeftSite = State.Arcs[Middle.Prev].Site;
+	int32 RightSite = State.Arcs[Middle.Next].Site;
+	if (LeftSite == RightSite) {
+		return;
+	}
+
+	const FVector2D& A = State.Sites[LeftSite];
+	const FVector2D& B = State.Sites[Middle.Site];
+	const FVector2D& C = State.Sites[RightSite];
+
+	// The breakpoints only converge when the three sites turn counter-clockwise; decided exactly so near-collinear triples are never misjudged
+	// The same exact value divides below, so a triple that passes never yields an infinite or flipped center
+	double D = 2.0 * GeometricPredicates::Orient2D(A, B, C);
+	if (D <= 0.0) {
+		return;
+	}
+
+	double BA = (B - A).SizeSquared();
+	double CA = (C - A).SizeSquared();
+	double CenterX = A.X + ((C.Y - A.Y) * BA - (B.Y - A.Y) * CA) / D;
+	double CenterY = A.Y + ((B.X - A.X) * CA - (C.X - A.X) * BA) / D;
+	double Radius = FVector2D::Distance(A, FVector2D(CenterX, CenterY));
+
+	Middle.EventId = State.NextEventId++;
+	State.Events.HeapPush({ CenterY + Radius, CenterX, ArcIndex, Middle.EventId }, CircleEventOrder());
+}
+
+/* X coordinate where the arc of Left meets the arc of Right, with Left to the left on the beach line */
+double FortuneSweep::ComputeBreakpoint(const FVector2D& Left, const FVector2D& Right, double SweepY)
+{
+	if (Left.Y == Right.Y) {
+		return (Left.X + Right.X) * 0.5;
+	}
+	if (Left.Y == SweepY) {
+		return Left.X;
+	}
+	if (Right.Y == SweepY) {
+		return Right.X;
+	}
+
+	double DL = 2.0 * (Left.Y - SweepY);
+	double DR = 2.0 * (Right.Y - SweepY);
+
+	double A = DR - DL;
+	double B = -2.0 * (DR * Left.X - DL * Right.X);
+	double C = DR * (Left.X * Left.X + Left.Y * Left.Y - SweepY * SweepY)
+			 - DL * (Right.X * Right.X + Right.Y * Right.Y - SweepY * SweepY);
+
+	double Root = FMath::Sqrt(FMath::Max(B * B - 4.0 * A * C, 0.0));
+	double X1 = (-B - Root) / (2.0 * A);
+	double X2 = (-B + Root) / (2.0 * A);
+
+	// The arc closer to the sweep line is narrower and lies on top between the two intersections
+	return (Left.Y > Right.Y) ? FMath::Max(X1, X2) : FMath::Min(X1, X2);
+}
+
+int32 FortuneSweep::AddArc(int32 SiteIndex, SweepState& State)
+{
+	return State.Arcs.Add({ SiteIndex, INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE, INDEX_NONE, State.Priorities.GetUnsignedInt() });
+}
+
+/* Arc whose breakpoints enclose P.X at the sweep line through P */
+int32 FortuneSweep::FindArcAbove(const FVector2D& P, const SweepState& State)
+{
+	int32 Node = State.Root;
+	while (true)
+	{
+		const Arc& Current = State.Arcs[Node];
+		const FVector2D& Site = State.Sites[Current.Site];
+
+		int32 Child = INDEX_NONE;
+		if (Current.Prev != INDEX_NONE && P.X < ComputeBreakpoint(State.Sites[State.Arcs[Current.Prev].Site], Site, P.Y)) {
+			Child = Current.Left;
+		}
+		else if (Current.Next != INDEX_NONE && P.X >= ComputeBreakpoint(Site, State.Sites[State.Arcs[Current.Next].Site], P.Y)) {
+			Child = Current.Right;
+		}
+
+		// A missing child means the neighbor is an ancestor that already sent the search here
+		if (Child == INDEX_NONE) {
+			return Node;
+		}
+		Node = Child;
+	}
+}
+
+/* Links NewArc into the treap as the in-order successor of ArcIndex; the beach line links are the caller's */
+void FortuneSweep::InsertArcAfter(int32 ArcIndex, int32 NewArc, SweepState& State)
+{
+	int32 Parent = ArcIndex;
+	if (State.Arcs[Parent].Right == INDEX_NONE) {
+		State.Arcs[Parent].Right = NewArc;
+	}
+	else
+	{
+		Parent = State.Arcs[Parent].Right;
+		while (State.Arcs[Parent].Left != INDEX_NONE) {
+			Parent = State.Arcs[Parent].Left;
+		}
+		State.Arcs[Parent].Left = NewArc;
+	}
+	State.Arcs[NewArc].Parent = Parent;
+
+	while (State.Arcs[NewArc].Parent != INDEX_NONE && State.Arcs[NewArc].Priority < State.Arcs[State.Arcs[NewArc].Parent].Priority) {
+		RotateUp(NewArc, State);
+	}
+}
+
+void FortuneSweep::RemoveArc(int32 ArcIndex, SweepState& State)
+{
+	// Rotate the arc down to a leaf, keeping the heap order on priorities
+	while (true)
+	{
+		const int32 Left = State.Arcs[ArcIndex].Left;
+		const int32 Right = State.Arcs[ArcIndex].Right;
+		if (Left == INDEX_NONE && Right == INDEX_NONE) {
+			break;
+		}
+		const bool bLeft = Right == INDEX_NONE || (Left != INDEX_NONE && State.Arcs[Left].Priority < State.Arcs[Right].Priority);
+		RotateUp(bLeft ? Left : Right, State);
+	}
+
+	const int32 Parent = State.Arcs[ArcIndex].Parent;
+	if (Parent == INDEX_NONE) {
+		State.Root = INDEX_NONE;
+	}
+	else if (State.Arcs[Parent].Left == ArcIndex) {
+		State.Arcs[Parent].Left = INDEX_NONE;
+	}
+	else {
+		State.Arcs[Parent].Right = INDEX_NONE;
+	}
+	State.Arcs[ArcIndex].Parent = INDEX_NONE;
+}
+
+/* Swaps ArcIndex with its parent, preserving the in-order sequence */
+void FortuneSweep::RotateUp(int32 ArcIndex, SweepState& State)
+{
+	const int32 Parent = State.Arcs[ArcIndex].Parent;
+	const int32 Grandparent = State.Arcs[Parent].Parent;
+
+	if (State.Arcs[Parent].Left == ArcIndex)
+	{
+		const int32 Inner = State.Arcs[ArcIndex].Right;
+		State.Arcs[Parent].Left = Inner;
+		if (Inner != INDEX_NONE) {
+			State.Arcs[Inner].Parent = Parent;
+		}
+		State.Arcs[ArcIndex].Right = Parent;
+	}
+	else
+	{
+		const int32 Inner = State.Arcs[ArcIndex].Left;
+		State.Arcs[Parent].Right = Inner;
+		if (Inner != INDEX_NONE) {
+			State.Arcs[Inner].Parent = Parent;
+		}
+		State.Arcs[ArcIndex].Left = Parent;
+	}
+	State.Arcs[Parent].Parent = ArcIndex;
+	State.Arcs[ArcIndex].Parent = Grandparent;
+
+	if (Grandparent == INDEX_NONE) {
+		State.Root = ArcIndex;
+	}
+	else if (State.Arcs[Grandparent].Left == Parent) {
+		State.Arcs[Grandparent].Left = ArcIndex;
+	}
+	else {
+		State.Arcs[Grandparent].Right = ArcIndex;
+	}
+}
+
+void FortuneSweep::AddNeighbors(int32 SiteA, int32 SiteB, SweepState& State)
+{
+	State.Neighbors[SiteA].AddUnique(SiteB);
+	State.Neighbors[SiteB].AddUnique(SiteA);
+}
+
+/* Keeps the half of Polygon that is closer to Site than to Neighbor */
+void FortuneSweep::ClipToBisector(const FVector2D& Site, const FVector2D& Neighbor, TArray<FVector2D>& Polygon, TArray<FVector2D>& Scratch)
+{
+	const FVector2D Normal = Neighbor - Site;
+	const double Offset = 0.5 * (Neighbor.SizeSquared() - Site.SizeSquared());
+
+	Scratch.Reset();
+	for (int32 i = 0; i < Polygon.Num(); ++i)
+	{
+		const FVector2D& Curr = Polygon[i];
+		const FVector2D& Next = Polygon[(i + 1) % Polygon.Num()];
+
+		double CurrSide = FVector2D::DotProduct(Curr, Normal) - Offset;
+		double NextSide = FVector2D::DotProduct(Next, Normal) - Offset;
+
+		if (CurrSide <= 0.0) {
+			Scratch.Add(Curr);
+		}
+		if ((CurrSide < 0.0 && NextSide > 0.0) || (CurrSide > 0.0 && NextSide < 0.0)) {
+			double t = CurrSide / (CurrSide - NextSide);
+			Scratch.Add(Curr + (Next - Curr) * t);
+		}
+	}
+	Swap(Polygon, Scratch);
+}
@@ -0,0 +1,65 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlassFracture/TriangulationTypes.h"
+
+/**
+ * FortuneSweep builds Voronoi cells with Fortune's sweep-line algorithm.
+ * The sweep finds the neighboring sites of every cell, and each cell is then cut out of the pane rectangle
+ * by the bisectors of its neighbors, so no separate clipping pass against the bounding box is needed.
+ * The beach line is a treap ordered along X, so finding the arc above a site is O(log n) expected and the sweep is O(n log n).
+ */
+class GLASSFRACTURE_API FortuneSweep
+{
+public:
+	static TArray<Piece> GenerateVoronoiCells(const TArray<Point>& Sites, const FVector& LocalMinBound, const FVector& LocalMaxBound);
+
+private:
+	struct Arc
+	{
+		int32 Site;
+		int32 Prev;		// Neighbors on the beach line
+		int32 Next;
+		int32 EventId;
+
+		// Treap links, in-order along the beach line
+		int32 Parent;
+		int32 Left;
+		int32 Right;
+		uint32 Priority;
+	};
+
+	struct CircleEvent
+	{
+		double Y;
+		double X;
+		int32 Arc;
+		int32 Id;
+	};
+
+	struct SweepState
+	{
+		TArray<FVector2D> Sites;
+		TArray<Arc> Arcs;
+		TArray<CircleEvent> Events;
+		TArray<TArray<int32>> Neighbors;
+
+		int32 Root = INDEX_NONE;
+		int32 NextEventId = 0;
+		FRandomStream Priorities = FRandomStream(0x5EED);
+	};
+
+	static void HandleSiteEvent(int32 SiteIndex, SweepState& State);
+	static void HandleCircleEvent(const CircleEvent& Event, SweepState& State);
+	static void CheckCircleEvent(int32 ArcIndex, SweepState& State);
+	static double ComputeBreakpoint(const FVector2D& Left, const FVector2D& Right, double SweepY);
+	static int32 AddArc(int32 SiteIndex, SweepState& State);
+	static int32 FindArcAbove(const FVector2D& P, const SweepState& State);
+	static void InsertArcAfter(int32 ArcIndex, int32 NewArc, SweepState& State);
+	static void RemoveArc(int32 ArcIndex, SweepState& State);
+	static void RotateUp(int32 ArcIndex, SweepState& State);
+	static void AddNeighbors(int32 SiteA, int32 SiteB, SweepState& State);
+	static void ClipToBisector(const FVector2D& Site, const FVector2D& Neighbor, TArray<FVector2D>& Polygon, TArray<FVector2D>& Scratch);
+};
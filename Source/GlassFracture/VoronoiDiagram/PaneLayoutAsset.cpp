@@ -0,0 +1,81 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PaneLayoutAsset.h"
+#include "GlassFracture/GlassFracture.h"
+#include "Hash/CityHash.h"
+
+namespace
+{
+	// Pane sizes come from scaled mesh bounds, so allow for float noise
+	constexpr double PaneSizeTolerance = 0.01;
+}
+
+uint64 FBakedPaneLayout::GetContentHash() const
+{
+	const uint64 Hash = CityHash64((const char*)CellVertices.GetData(), CellVertices.Num() * CellVertices.GetTypeSize());
+	return CityHash64WithSeed((const char*)CellOffsets.GetData(), CellOffsets.Num() * CellOffsets.GetTypeSize(), Hash);
+}
+
+const FBakedPaneLayout* UPaneLayoutAsset::FindLayout(const FVector2D& PaneSize, int32 Seed, uint64 SettingsHash) const
+{
+	const FBakedPaneLayout* Layout = FindByKey(PaneSize, Seed);
+	if (Layout && Layout->SettingsHash != SettingsHash) {
+		UE_LOG(LogGlassFracture, Warning, TEXT("%s: layout for pane %s, seed %d was baked with other site settings, generating it at runtime instead. Rebake to load it again."),
+			*GetName(), *PaneSize.ToString(), Seed);
+		return nullptr;
+	}
+	return Layout;
+}
+
+void UPaneLayoutAsset::StoreLayout(const FVector2D& PaneSize, int32 Seed, uint64 SettingsHash, const FVector2D& MinCorner, const TArray<Piece>& Pieces)
+{
+	FBakedPaneLayout* Layout = const_cast<FBakedPaneLayout*>(FindByKey(PaneSize, Seed));
+	if (!Layout) {
+		Layout = &Layouts.AddDefaulted_GetRef();
+	}
+
+	Layout->PaneSize = PaneSize;
+	Layout->Seed = Seed;
+	Layout->SettingsHash = SettingsHash;
+	SavePieces(*Layout, MinCorner, Pieces);
+}
+
+const FBakedPaneLayout* UPaneLayoutAsset::FindByKey(const FVector2D& PaneSize, int32 Seed) const
+{
+	return Layouts.FindByPredicate([&PaneSize, Seed](const FBakedPaneLayout& Layout) {
+		return Layout.Seed == Seed && Layout.PaneSize.Equals(PaneSize, PaneSizeTolerance);
+	});
+}
+
+void UPaneLayoutAsset::SavePieces(FBakedPaneLayout& Layout, const FVector2D& MinCorner, const TArray<Piece>& Pieces)
+{
+	Layout.CellVertices.Reset();
+	Layout.CellOffsets.Reset(Pieces.Num() + 1);
+	Layout.CellOffsets.Add(0);
+
+	for (const Piece& piece : Pieces) {
+		for (const Point& point : piece.points) {
+			Layout.CellVertices.Add(FVector2f(FVector2D(point.x, point.z) - MinCorner));
+		}
+		Layout.CellOffsets.Add(Layout.CellVertices.Num());
+	}
+}
+
+TArray<Piece> UPaneLayoutAsset::LoadPieces(const FBakedPaneLayout& Layout, const FVector2D& MinCorner)
+{
+	TArray<Piece> Pieces;
+	Pieces.Reserve(Layout.NumCells());
+
+	TArray<Point> CellPoints;
+	for (int32 c = 0; c < Layout.NumCells(); ++c) {
+		CellPoints.Reset();
+		for (int32 i = Layout.CellOffsets[c]; i < Layout.CellOffsets[c + 1]; ++i) {
+			const FVector2f& V = Layout.CellVertices[i];
+			CellPoints.Add(Point(V.X + MinCorner.X, V.Y + MinCorner.Y));
+		}
+		Pieces.Add(Piece(CellPoints));
+	}
+
+	return Pieces;
+}
@@ -0,0 +1,63 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "GlassFracture/TriangulationTypes.h"
+#include "PaneLayoutAsset.generated.h"
+
+/* One baked pre-fracture layout. Cell c owns CellVertices[CellOffsets[c] .. CellOffsets[c + 1]), relative to the pane's min corner */
+USTRUCT()
+struct GLASSFRACTURE_API FBakedPaneLayout
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Key")
+	FVector2D PaneSize = FVector2D::ZeroVector;
+
+	UPROPERTY(VisibleAnywhere, Category = "Key")
+	int32 Seed = 0;
+
+	// Hash of the site and Voronoi settings the layout was generated with; a pane whose settings differ ignores the bake
+	UPROPERTY(VisibleAnywhere, Category = "Key")
+	uint64 SettingsHash = 0;
+
+	UPROPERTY()
+	TArray<FVector2f> CellVertices;
+
+	UPROPERTY()
+	TArray<int32> CellOffsets;
+
+	int32 NumCells() const { return FMath::Max(CellOffsets.Num() - 1, 0); }
+
+	uint64 GetContentHash() const;
+};
+
+/**
+ * Voronoi layouts baked in the editor, keyed by pane size (X, Z) and seed.
+ * Panes with a matching entry load their intact pieces from here instead of sampling and triangulating in BeginPlay,
+ * as long as they were baked with the pane's current site settings.
+ */
+UCLASS(BlueprintType)
+class GLASSFRACTURE_API UPaneLayoutAsset : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(VisibleAnywhere, Category = "Layouts")
+	TArray<FBakedPaneLayout> Layouts;
+
+	/* Layout for (PaneSize, Seed), or null with a warning when it was baked from other settings and has to be rebaked */
+	const FBakedPaneLayout* FindLayout(const FVector2D& PaneSize, int32 Seed, uint64 SettingsHash) const;
+
+	/* Adds or replaces the layout for (PaneSize, Seed); Pieces are in pane-local space with the min corner at MinCorner */
+	void StoreLayout(const FVector2D& PaneSize, int32 Seed, uint64 SettingsHash, const FVector2D& MinCorner, const TArray<Piece>& Pieces);
+
+	/* Writes Pieces into Layout's cells, leaving its key alone; LoadPieces reads them back */
+	static void SavePieces(FBakedPaneLayout& Layout, const FVector2D& MinCorner, const TArray<Piece>& Pieces);
+	static TArray<Piece> LoadPieces(const FBakedPaneLayout& Layout, const FVector2D& MinCorner);
+
+private:
+	const FBakedPaneLayout* FindByKey(const FVector2D& PaneSize, int32 Seed) const;
+};
@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PoissonDiskSampler.h"
+#include "GlassFracture/GlassFracture.h"
+
+namespace
+{
+	constexpr int32 MaxAttempts = 30;
+	constexpr int32 MaxPasses = 8;
+
+	// A finished Bridson pass holds about PackingDensity / Radius^2 samples per unit area
+	constexpr double PackingDensity = 0.7;
+
+	// Each pass that comes up short shrinks the spacing by this much and resumes from the samples already placed
+	constexpr double ShrinkPerPass = 0.9;
+}
+
+TArray<Point> PoissonDiskSampler::Sample(FRandomStream& Stream, const FBox2D& Region, float MinDistance, int32 NumPoints, const SiteDensitySettings& Density)
+{
+	TArray<Point> Result;
+
+	if (NumPoints <= 0 || !Region.bIsValid || Region.GetArea() <= 0.0) {
+		return Result;
+	}
+
+	// Spacing at which a full pass lands close to NumPoints, wider than MinDistance whenever the region allows it
+	double Radius = EstimateSpacing(Region, NumPoints, Density);
+	if (Radius < MinDistance) {
+		UE_LOG(LogGlassFracture, Log, TEXT("%d sites do not fit %.1f apart, spacing reduced to %.1f"), NumPoints, MinDistance, Radius);
+	}
+
+	const double MinScale = (Density.Mode == ESiteDensity::Uniform) ? 1.0 : FMath::Clamp((double)Density.DenseSpacing, 0.1, 1.0);
+
+	TArray<FVector2D> Samples;
+	TArray<int32> Active;
+	SampleGrid Grid;
+	Samples.Reserve(NumPoints + NumPoints / 2);
+
+	for (int32 Pass = 0; Pass < MaxPasses && Samples.Num() < NumPoints; ++Pass)
+	{
+		if (Pass > 0) {
+			Radius *= ShrinkPerPass;
+		}
+
+		// Cells are small enough that no two samples can share one, even where the spacing is tightest
+		ResetGrid(Grid, Region, Radius * MinScale / UE_SQRT_2, Samples);
+
+		Active.Reset();
+		for (int32 i = 0; i < Samples.Num(); ++i) {
+			Active.Add(i);
+		}
+
+		if (Samples.Num() == 0) {
+			FVector2D Seed(Stream.FRandRange(Region.Min.X, Region.Max.X), Stream.FRandRange(Region.Min.Y, Region.Max.Y));
+			Grid.Cells[CellIndex(Grid, Seed)] = Samples.Add(Seed);
+			Active.Add(0);
+		}
+
+		while (Active.Num() > 0)
+		{
+			const int32 Slot = Stream.RandHelper(Active.Num());
+			const FVector2D Origin = Samples[Active[Slot]];
+			const double OriginRadius = Radius * SpacingScale(Origin, Density);
+
+			bool bPlaced = false;
+			for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
+			{
+				// Uniform direction, distance within [r, 2r] of the active sample
+				const double Angle = Stream.FRandRange(0.0f, 2.0f * PI);
+				const double Distance = OriginRadius * (1.0 + Stream.FRand());
+				const FVector2D Candidate = Origin + FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * Distance;
+
+				if (!Region.IsInside(Candidate)) {
+					continue;
+				}
+				if (!IsFarEnough(Grid, Samples, Candidate, Radius * SpacingScale(Candidate, Density))) {
+					continue;
+				}
+
+				const int32 NewIndex = Samples.Add(Candidate);
+				Grid.Cells[CellIndex(Grid, Candidate)] = NewIndex;
+				Active.Add(NewIndex);
+				bPlaced = true;
+				break;
+			}
+
+			if (!bPlaced) {
+				Active.RemoveAtSwap(Slot, 1, false);
+			}
+		}
+	}
+
+	// Still short after every shrink, e.g. in a sliver of a region: the rest come uniformly from the stream, so the count always holds
+	if (Samples.Num() < NumPoints) {
+		UE_LOG(LogGlassFracture, Log, TEXT("Poisson sampling placed %d of %d sites, the rest are uniform"), Samples.Num(), NumPoints);
+		while (Samples.Num() < NumPoints) {
+			Samples.Add(FVector2D(Stream.FRandRange(Region.Min.X, Region.Max.X), Stream.FRandRange(Region.Min.Y, Region.Max.Y)));
+		}
+	}
+
+	// Drop a random subset of any surplus; the survivors keep their spacing
+	if (Samples.Num() > NumPoints) {
+		for (int32 i = 0; i < NumPoints; ++i) {
+			Samples.Swap(i, i + Stream.RandHelper(Samples.Num() - i));
+		}
+		Samples.SetNum(NumPoints, false);
+	}
+
+	Result.Reserve(Samples.Num());
+	for (const FVector2D& S : Samples) {
+		Result.Add(Point(S.X, S.Y));
+	}
+	return Result;
+}
+
+/* Local spacing multiplier, DenseSpacing at the densest spot and 1 beyond the falloff distance */
+double PoissonDiskSampler::SpacingScale(const FVector2D& P, const SiteDensitySettings& Density)
+{
+	double Distance = 0.0;
+
+	switch (Density.Mode) {
+	case ESiteDensity::Uniform:
+		return 1.0;
+	case ESiteDensity::FrameEdges:
+		Distance = FMath::Min(FMath::Min(P.X - Density.Frame.Min.X, Density.Frame.Max.X - P.X),
+							  FMath::Min(P.Y - Density.Frame.Min.Y, Density.Frame.Max.Y - P.Y));
+		break;
+	case ESiteDensity::ImpactZone:
+		Distance = FVector2D::Distance(P, Density.Focus);
+		break;
+	}
+
+	if (Density.Falloff <= 0.0f) {
+		return 1.0;
+	}
+	const double Dense = FMath::Clamp((double)Density.DenseSpacing, 0.1, 1.0);
+	return FMath::Lerp(Dense, 1.0, FMath::Clamp(Distance / Density.Falloff, 0.0, 1.0));
+}
+
+/* Solves NumPoints = PackingDensity * Integral(1 / (Radius * Scale)^2) over the region for Radius */
+double PoissonDiskSampler::EstimateSpacing(const FBox2D& Region, int32 NumPoints, const SiteDensitySettings& Density)
+{
+	const int32 Steps = (Density.Mode == ESiteDensity::Uniform) ? 1 : 16;
+	const FVector2D Step = Region.GetSize() * (1.0 / Steps);
+
+	double WeightedArea = 0.0;
+	for (int32 i = 0; i < Steps; ++i) {
+		for (int32 j = 0; j < Steps; ++j) {
+			FVector2D P = Region.Min + FVector2D((i + 0.5) * Step.X, (j + 0.5) * Step.Y);
+			WeightedArea += 1.0 / FMath::Square(SpacingScale(P, Density));
+		}
+	}
+	WeightedArea *= Step.X * Step.Y;
+
+	return FMath::Sqrt(PackingDensity * WeightedArea / NumPoints);
+}
+
+void PoissonDiskSampler::ResetGrid(SampleGrid& Grid, const FBox2D& Region, double CellSize, const TArray<FVector2D>& Samples)
+{
+	Grid.Origin = Region.Min;
+	Grid.CellSize = CellSize;
+	Grid.NumX = FMath::FloorToInt32(Region.GetSize().X / CellSize) + 1;
+	Grid.NumZ = FMath::FloorToInt32(Region.GetSize().Y / CellSize) + 1;
+	Grid.Cells.Init(INDEX_NONE, Grid.NumX * Grid.NumZ);
+
+	for (int32 i = 0; i < Samples.Num(); ++i) {
+		Grid.Cells[CellIndex(Grid, Samples[i])] = i;
+	}
+}
+
+int32 PoissonDiskSampler::CellIndex(const SampleGrid& Grid, const FVector2D& P)
+{
+	const int32 X = FMath::Clamp(FMath::FloorToInt32((P.X - Grid.Origin.X) / Grid.CellSize), 0, Grid.NumX - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt32((P.Y - Grid.Origin.Y) / Grid.CellSize), 0, Grid.NumZ - 1);
+	return Z * Grid.NumX + X;
+}
+
+bool PoissonDiskSampler::IsFarEnough(const SampleGrid& Grid, const TArray<FVector2D>& Samples, const FVector2D& Candidate, double Radius)
+{
+	const int32 Reach = FMath::CeilToInt32(Radius / Grid.CellSize);
+	const int32 CX = FMath::FloorToInt32((Candidate.X - Grid.Origin.X) / Grid.CellSize);
+	const int32 CZ = FMath::FloorToInt32((Candidate.Y - Grid.Origin.Y) / Grid.CellSize);
+	const double RadiusSquared = Radius * Radius;
+
+	for (int32 Z = FMath::Max(CZ - Reach, 0); Z <= FMath::Min(CZ + Reach, Grid.NumZ - 1); ++Z) {
+		for (int32 X = FMath::Max(CX - Reach, 0); X <= FMath::Min(CX + Reach, Grid.NumX - 1); ++X) {
+			const int32 Other = Grid.Cells[Z * Grid.NumX + X];
+			if (Other != INDEX_NONE && (Samples[Other] - Candidate).SizeSquared() < RadiusSquared) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GlassFracture/TriangulationTypes.h"
+#include "SiteDensity.h"
+
+struct SiteDensitySettings
+{
+	ESiteDensity Mode = ESiteDensity::Uniform;
+	float DenseSpacing = 0.5f;		// Spacing multiplier where the density peaks, in (0, 1]
+	float Falloff = 100.0f;			// Distance over which the spacing returns to normal
+	FBox2D Frame = FBox2D(ForceInit);	// Border used by FrameEdges
+	FVector2D Focus = FVector2D::ZeroVector;	// Center used by ImpactZone
+};
+
+/**
+ * PoissonDiskSampler generates Voronoi sites with Bridson's algorithm.
+ * A background grid with one sample per cell makes every distance check constant time, and the spacing is derived from
+ * the requested count so that exactly NumPoints sites are returned in O(n).
+ * Should the shrinking passes still come up short, the remaining sites are drawn uniformly from the same stream.
+ */
+class GLASSFRACTURE_API PoissonDiskSampler
+{
+public:
+	/* Sites inside Region, at least MinDistance apart unless NumPoints cannot fit, scaled by the density field */
+	static TArray<Point> Sample(FRandomStream& Stream, const FBox2D& Region, float MinDistance, int32 NumPoints, const SiteDensitySettings& Density = SiteDensitySettings());
+
+private:
+	struct SampleGrid
+	{
+		FVector2D Origin;
+		double CellSize;
+		int32 NumX;
+		int32 NumZ;
+		TArray<int32> Cells;	// Index into the sample list, INDEX_NONE when empty
+	};
+
+	static double SpacingScale(const FVector2D& P, const SiteDensitySettings& Density);
+	static double EstimateSpacing(const FBox2D& Region, int32 NumPoints, const SiteDensitySettings& Density);
+	static void ResetGrid(SampleGrid& Grid, const FBox2D& Region, double CellSize, const TArray<FVector2D>& Samples);
+	static int32 CellIndex(const SampleGrid& Grid, const FVector2D& P);
+	static bool IsFarEnough(const SampleGrid& Grid, const TArray<FVector2D>& Samples, const FVector2D& Candidate, double Radius);
+};
@@ -0,0 +1,17 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SiteDensity.generated.h"
+
+/**
+ * Where PoissonDiskSampler packs Voronoi sites more tightly.
+ */
+UENUM(BlueprintType)
+enum class ESiteDensity : uint8
+{
+	Uniform,		// Same spacing everywhere
+	FrameEdges,		// Denser towards the pane border
+	ImpactZone		// Denser around a predicted impact point
+};
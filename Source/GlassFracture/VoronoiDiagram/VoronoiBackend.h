@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VoronoiBackend.generated.h"
+
+/**
+ * Engine used by VoronoiGenerator to build the pre-fracture cells.
+ */
+UENUM(BlueprintType)
+enum class EVoronoiBackend : uint8
+{
+	Delaunay,	// Dual of the Bowyer-Watson triangulation, clipped to the pane afterwards
+	Fortune		// Sweep-line construction, clipped to the pane while the cells are built
+};
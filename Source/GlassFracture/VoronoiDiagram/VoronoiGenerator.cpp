@@ -3,10 +3,16 @@
 
 #include "VoronoiGenerator.h"
 #include "DelaunayTriangulator.h"
+#include "FortuneSweep.h"
 #include "GlassFracture/PolygonClipper.h"
 
-TArray<Piece> VoronoiGenerator::GenerateVoronoiCells(const TArray<Point>& RandomPoints, const FVector& LocalMinBound, const FVector& LocalMaxBound)
+TArray<Piece> VoronoiGenerator::GenerateVoronoiCells(const TArray<Point>& RandomPoints, const FVector& LocalMinBound, const FVector& LocalMaxBound, EVoronoiBackend Backend)
 {
+	if (Backend == EVoronoiBackend::Fortune)
+	{
+		return FortuneSweep::GenerateVoronoiCells(RandomPoints, LocalMinBound, LocalMaxBound);
+	}
+
 	TArray<Piece> VoronoiPieces;
 
 	TArray<Point> BoundingBox = {
@@ -48,23 +54,19 @@ TArray<Piece> VoronoiGenerator::GenerateVoronoiCells(const TArray<Point>& Random
 TArray<Piece> VoronoiGenerator::CreateVoronoiPieces(const TMap<Point, TArray<Point>>& VoronoiCells, const TArray<Point>& BoundingBox)
 {
 	TArray<Piece> VoronoiPieces;
+	VoronoiPieces.Reserve(VoronoiCells.Num());
+
+	PolygonClipper::ClipScratch Scratch;
 
 	for (const auto& Cell : VoronoiCells)
 	{
-		const Point& Site = Cell.Key;
 		const TArray<Point>& Circumcenters = Cell.Value;
 
-		TArray<Point> VoronoiPolygon;
-		for (const Point& V : Circumcenters)
-		{
-			VoronoiPolygon.Add(Point(V.x, V.z));
-		}
-
-		TArray<Point> ClippedPolygon = PolygonClipper::PerformClipping(VoronoiPolygon, BoundingBox);
+		TArrayView<const Point> ClippedPolygon = PolygonClipper::ClipConvex(Circumcenters, BoundingBox, Scratch);
 
 		if (ClippedPolygon.Num() > 2)
 		{
-			VoronoiPieces.Add(Piece(ClippedPolygon));
+			VoronoiPieces.Add(Piece(TArray<Point>(ClippedPolygon)));
 		}
 	}
 
@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GlassFracture/TriangulationTypes.h"
+#include "VoronoiBackend.h"
 
 /**
  * 
@@ -11,7 +12,8 @@
 class GLASSFRACTURE_API VoronoiGenerator
 {
 public:
-	static TArray<Piece> GenerateVoronoiCells(const TArray<Point>& RandomPoints, const FVector& LocalMinBound, const FVector& LocalMaxBound);
+	static TArray<Piece> GenerateVoronoiCells(const TArray<Point>& RandomPoints, const FVector& LocalMinBound, const FVector& LocalMaxBound,
+			EVoronoiBackend Backend = EVoronoiBackend::Delaunay);
 
 private:
 	static TArray<Piece> CreateVoronoiPieces(const TMap<Point, TArray<Point>>& VoronoiCells, const TArray<Point>& BoundingBox);
@@ -11,5 +11,6 @@ public class GlassFractureEditorTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V2;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Unreal5_1;
 		ExtraModuleNames.Add("GlassFracture");
+		ExtraModuleNames.Add("GlassFractureEditor");
 	}
 }
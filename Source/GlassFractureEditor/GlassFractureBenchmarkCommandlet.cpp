@@ -0,0 +1,340 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GlassFractureBenchmarkCommandlet.h"
+#include "GlassFracture/GlassFracture.h"
+#include "GlassFracture/FractureJob.h"
+#include "GlassFracture/PolygonClipper.h"
+#include "GlassFracture/PatternCells/FracturePatternAsset.h"
+#include "GlassFracture/PatternCells/FracturePatternGenerator.h"
+#include "GlassFracture/VoronoiDiagram/DelaunayTriangulator.h"
+#include "GlassFracture/VoronoiDiagram/PoissonDiskSampler.h"
+#include "GlassFracture/VoronoiDiagram/VoronoiGenerator.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	const FBox2D PaneBox(FVector2D(-500.0, -500.0), FVector2D(500.0, 500.0));
+	constexpr float ImpactRadius = 80.0f;
+	constexpr float PatternRadius = 400.0f;
+}
+
+UGlassFractureBenchmarkCommandlet::UGlassFractureBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UGlassFractureBenchmarkCommandlet::Main(const FString& Params)
+{
+	TArray<FString> Tokens;
+	TArray<FString> Switches;
+	TMap<FString, FString> ParamValues;
+	ParseCommandLine(*Params, Tokens, Switches, ParamValues);
+
+	if (const FString* Value = ParamValues.Find(TEXT("Iterations")))
+	{
+		Iterations = FMath::Max(FCString::Atoi(**Value), 1);
+	}
+	if (const FString* Value = ParamValues.Find(TEXT("Seed")))
+	{
+		Seed = FCString::Atoi(**Value);
+	}
+	const TArray<int32> SiteCounts = ParseCounts(ParamValues, TEXT("Sites"), TEXT("10,100,1000,10000,100000"));
+	const TArray<int32> RingCounts = ParseCounts(ParamValues, TEXT("Rings"), TEXT("4,8,16"));
+	const TArray<int32> SpokeCounts = ParseCounts(ParamValues, TEXT("Spokes"), TEXT("8,16,32"));
+	const TArray<int32> JobSiteCounts = ParseCounts(ParamValues, TEXT("JobSites"), TEXT("100,1000,10000"));
+
+	FString OutputPath = ParamValues.FindRef(TEXT("Output"));
+	if (OutputPath.IsEmpty())
+	{
+		OutputPath = FPaths::ProjectSavedDir() / TEXT("Benchmarks") / TEXT("GlassFracture.json");
+	}
+
+	if (GetTrackedBytes() == INDEX_NONE)
+	{
+		UE_LOG(LogGlassFracture, Display, TEXT("Run with -llm to record the bytes each stage holds"));
+	}
+
+	for (int32 NumSites : SiteCounts)
+	{
+		RunSiteSweep(NumSites);
+	}
+	for (int32 Rings : RingCounts)
+	{
+		for (int32 Spokes : SpokeCounts)
+		{
+			RunPatternSweep(Rings, Spokes, JobSiteCounts);
+		}
+	}
+
+	if (!FFileHelper::SaveStringToFile(ToJson(), *OutputPath))
+	{
+		UE_LOG(LogGlassFracture, Error, TEXT("Could not write benchmark results to %s"), *OutputPath);
+		return 1;
+	}
+	UE_LOG(LogGlassFracture, Display, TEXT("%d benchmark samples written to %s"), Samples.Num(), *OutputPath);
+	return 0;
+}
+
+void UGlassFractureBenchmarkCommandlet::RunSiteSweep(int32 NumSites)
+{
+	StageSample Sample;
+	Sample.Sites = NumSites;
+
+	TArray<Point> Sites;
+	Sample.Stage = TEXT("Sample");
+	Measure(Sample, [&]() { Sites.Empty(); }, [&]() {
+		FRandomStream Stream(Seed);
+		Sites = PoissonDiskSampler::Sample(Stream, PaneBox, 1.0f, NumSites);
+		return Sites.Num();
+	});
+
+	TArray<Triangle> Triangles;
+	Sample.Stage = TEXT("Delaunay");
+	Measure(Sample, [&]() { Triangles.Empty(); }, [&]() {
+		Triangles = DelaunayTriangulator::ComputeTriangulation(Sites);
+		return Triangles.Num();
+	});
+	Triangles.Empty();
+
+	const FVector MinBound(PaneBox.Min.X, 0.0, PaneBox.Min.Y);
+	const FVector MaxBound(PaneBox.Max.X, 0.0, PaneBox.Max.Y);
+
+	TArray<Piece> Cells;
+	Sample.Stage = TEXT("Voronoi.Delaunay");
+	Measure(Sample, [&]() { Cells.Empty(); }, [&]() {
+		Cells = VoronoiGenerator::GenerateVoronoiCells(Sites, MinBound, MaxBound, EVoronoiBackend::Delaunay);
+		return Cells.Num();
+	});
+
+	TArray<Piece> FortuneCells;
+	Sample.Stage = TEXT("Voronoi.Fortune");
+	Measure(Sample, [&]() { FortuneCells.Empty(); }, [&]() {
+		FortuneCells = VoronoiGenerator::GenerateVoronoiCells(Sites, MinBound, MaxBound, EVoronoiBackend::Fortune);
+		return FortuneCells.Num();
+	});
+	FortuneCells.Empty();
+
+	// Every cell against one clockwise octagon at the pane center, through the allocating entry point
+	TArray<Point> ClipPolygon;
+	for (int32 i = 0; i < 8; ++i)
+	{
+		const double Angle = -2.0 * PI * i / 8;
+		ClipPolygon.Add(Point(ImpactRadius * FMath::Cos(Angle), ImpactRadius * FMath::Sin(Angle)));
+	}
+
+	TArray<TArray<Point>> Clipped;
+	Sample.Stage = TEXT("Clip");
+	Measure(Sample, [&]() { Clipped.Empty(); }, [&]() {
+		Clipped.Reserve(Cells.Num());
+		for (const Piece& Cell : Cells)
+		{
+			TArray<Point> Result = PolygonClipper::PerformClipping(Cell.points, ClipPolygon);
+			if (Result.Num() > 0)
+			{
+				Clipped.Add(MoveTemp(Result));
+			}
+		}
+		return Clipped.Num();
+	});
+}
+
+/* The pattern once, then one FractureJob row per intact site count and impact */
+void UGlassFractureBenchmarkCommandlet::RunPatternSweep(int32 Rings, int32 Spokes, const TArray<int32>& JobSiteCounts)
+{
+	UFracturePatternAsset* Pattern = MakeSpiderwebPattern(Rings, Spokes, PatternRadius, Seed);
+	Pattern->AddToRoot();
+
+	StageSample Sample;
+	Sample.Rings = Rings;
+	Sample.Spokes = Spokes;
+
+	TArray<Piece> PatternPieces;
+	Sample.Stage = TEXT("Pattern");
+	Measure(Sample, [&]() { PatternPieces.Empty(); }, [&]() {
+		PatternPieces = FracturePatternGenerator::CreateSpiderwebPieces(FVector::ZeroVector, Pattern);
+		return PatternPieces.Num();
+	});
+	PatternPieces.Empty();
+
+	FractureJobInput Input;
+	Input.ImpactRadius = ImpactRadius;
+	Input.PaneBounds = PaneBox;
+	Input.SectionTiles = 4;
+	Input.bRebuildAllSections = true;
+	Input.Pattern = Pattern;
+
+	const TPair<const TCHAR*, FVector2D> Impacts[] = {
+		{ TEXT("Center"), FVector2D(0.0, 0.0) },
+		{ TEXT("Edge"), FVector2D(0.0, PaneBox.Min.Y + 50.0) },
+		{ TEXT("Corner"), PaneBox.Min + FVector2D(50.0, 50.0) },
+	};
+
+	Sample.Stage = TEXT("FractureJob");
+	for (int32 JobSites : JobSiteCounts)
+	{
+		FRandomStream Stream(Seed);
+		const TArray<Point> Sites = PoissonDiskSampler::Sample(Stream, PaneBox, 1.0f, JobSites);
+		Input.IntactPieces = VoronoiGenerator::GenerateVoronoiCells(Sites,
+			FVector(PaneBox.Min.X, 0.0, PaneBox.Min.Y), FVector(PaneBox.Max.X, 0.0, PaneBox.Max.Y), EVoronoiBackend::Delaunay);
+		Sample.Sites = Sites.Num();
+
+		for (const TPair<const TCHAR*, FVector2D>& Impact : Impacts)
+		{
+			Input.PatternLocation = FVector(Impact.Value.X, 0.0, Impact.Value.Y);
+			Input.ImpactCenter = Impact.Value;
+			Sample.Impact = Impact.Key;
+			FractureJobResult JobResult;
+			Measure(Sample, [&]() { JobResult = FractureJobResult(); }, [&]() {
+				JobResult = FractureJob::Run(Input);
+				return JobResult.ClippedPieces.Num();
+			});
+		}
+	}
+
+	Pattern->RemoveFromRoot();
+}
+
+void UGlassFractureBenchmarkCommandlet::Measure(StageSample Sample, TFunctionRef<void()> Release, TFunctionRef<int32()> Body)
+{
+	double TotalMs = 0.0;
+	double MinMs = UE_BIG_NUMBER;
+	int64 Bytes = 0;
+
+	for (int32 i = 0; i < Iterations; ++i)
+	{
+		// The previous output is freed outside the measured scope, so only this iteration's output is counted
+		Release();
+		const int64 BytesBefore = GetTrackedBytes();
+		const double StartTime = FPlatformTime::Seconds();
+
+		{
+			LLM_SCOPE_BYTAG(GlassFracture);
+			Sample.Outputs = Body();
+		}
+
+		const double Ms = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+		TotalMs += Ms;
+		MinMs = FMath::Min(MinMs, Ms);
+		if (BytesBefore != INDEX_NONE)
+		{
+			Bytes += GetTrackedBytes() - BytesBefore;
+		}
+	}
+
+	Sample.Iterations = Iterations;
+	Sample.MinMs = MinMs;
+	Sample.MeanMs = TotalMs / Iterations;
+	Sample.TrackedBytes = (GetTrackedBytes() == INDEX_NONE) ? INDEX_NONE : Bytes / Iterations;
+
+	UE_LOG(LogGlassFracture, Display, TEXT("%-16s sites %6d pattern %2dx%-2d %-6s  min %9.3f ms  mean %9.3f ms  %10lld bytes  %6d out"),
+		*Sample.Stage, Sample.Sites, Sample.Rings, Sample.Spokes, *Sample.Impact, Sample.MinMs, Sample.MeanMs,
+		Sample.TrackedBytes, Sample.Outputs);
+
+	Samples.Add(MoveTemp(Sample));
+}
+
+/* Bytes currently held under the GlassFracture LLM tag, on every thread; INDEX_NONE when LLM is off */
+int64 UGlassFractureBenchmarkCommandlet::GetTrackedBytes()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+	if (FLowLevelMemTracker::IsEnabled())
+	{
+		// Commandlets never tick, so fold the per-thread counters in before reading
+		FLowLevelMemTracker::Get().UpdateStatsPerFrame();
+		return FLowLevelMemTracker::Get().GetTagAmountForTracker(ELLMTracker::Default, LLM_TAG_NAME(GlassFracture), ELLMTagSet::None);
+	}
+#endif
+	return INDEX_NONE;
+}
+
+/* Rings x Spokes cells around the origin with jittered nodes, so some cells come out concave like hand-made patterns */
+UFracturePatternAsset* UGlassFractureBenchmarkCommandlet::MakeSpiderwebPattern(int32 Rings, int32 Spokes, float Radius, int32 PatternSeed)
+{
+	FRandomStream Stream(PatternSeed);
+	const float RingStep = Radius / Rings;
+	const float SpokeStep = 2.0f * PI / Spokes;
+
+	// Node (r, s) for r in 1..Rings sits on ring r at spoke s
+	TArray<FVector2f> Nodes;
+	Nodes.Reserve(Rings * Spokes);
+	for (int32 r = 1; r <= Rings; ++r)
+	{
+		for (int32 s = 0; s < Spokes; ++s)
+		{
+			const float NodeRadius = RingStep * (r + Stream.FRandRange(-0.2f, 0.2f));
+			const float Angle = SpokeStep * (s + Stream.FRandRange(-0.2f, 0.2f));
+			Nodes.Add(FVector2f(NodeRadius * FMath::Cos(Angle), NodeRadius * FMath::Sin(Angle)));
+		}
+	}
+	auto Node = [&Nodes, Spokes](int32 r, int32 s) { return Nodes[(r - 1) * Spokes + s % Spokes]; };
+
+	UFracturePatternAsset* Pattern = NewObject<UFracturePatternAsset>(GetTransientPackage());
+	Pattern->CellOffsets.Add(0);
+
+	// Clockwise, the winding cells are stored in
+	auto AddCell = [Pattern](std::initializer_list<FVector2f> Corners) {
+		FBox2D Bounds(ForceInit);
+		for (const FVector2f& Corner : Corners)
+		{
+			Pattern->CellVertices.Add(Corner);
+			Bounds += FVector2D(Corner);
+		}
+		Pattern->CellOffsets.Add(Pattern->CellVertices.Num());
+		Pattern->CellBounds.Add(Bounds);
+		Pattern->PatternBounds += Bounds;
+	};
+
+	for (int32 s = 0; s < Spokes; ++s)
+	{
+		AddCell({ FVector2f::ZeroVector, Node(1, s + 1), Node(1, s) });
+	}
+	for (int32 r = 1; r < Rings; ++r)
+	{
+		for (int32 s = 0; s < Spokes; ++s)
+		{
+			AddCell({ Node(r, s), Node(r, s + 1), Node(r + 1, s + 1), Node(r + 1, s) });
+		}
+	}
+
+	Pattern->BuildConvexParts();
+	return Pattern;
+}
+
+TArray<int32> UGlassFractureBenchmarkCommandlet::ParseCounts(const TMap<FString, FString>& ParamValues, const TCHAR* Key, const TCHAR* Default)
+{
+	const FString* Value = ParamValues.Find(Key);
+
+	TArray<FString> Entries;
+	(Value ? *Value : FString(Default)).ParseIntoArray(Entries, TEXT(","), true);
+
+	TArray<int32> Counts;
+	for (const FString& Entry : Entries)
+	{
+		const int32 Count = FCString::Atoi(*Entry);
+		if (Count > 0)
+		{
+			Counts.Add(Count);
+		}
+	}
+	return Counts;
+}
+
+FString UGlassFractureBenchmarkCommandlet::ToJson() const
+{
+	FString Json = TEXT("[\n");
+	for (int32 i = 0; i < Samples.Num(); ++i)
+	{
+		const StageSample& S = Samples[i];
+		Json += FString::Printf(TEXT("  {\"stage\": \"%s\", \"sites\": %d, \"rings\": %d, \"spokes\": %d, \"impact\": \"%s\", \"iterations\": %d, ")
+			TEXT("\"min_ms\": %.4f, \"mean_ms\": %.4f, \"llm_bytes\": %lld, \"outputs\": %d}%s\n"),
+			*S.Stage, S.Sites, S.Rings, S.Spokes, *S.Impact, S.Iterations,
+			S.MinMs, S.MeanMs, S.TrackedBytes, S.Outputs, (i + 1 < Samples.Num()) ? TEXT(",") : TEXT(""));
+	}
+	Json += TEXT("]\n");
+	return Json;
+}
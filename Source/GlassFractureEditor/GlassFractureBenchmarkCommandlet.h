@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GlassFractureBenchmarkCommandlet.generated.h"
+
+class UFracturePatternAsset;
+
+/**
+ * Headless benchmark of the fracture geometry core: site sampling, Delaunay, both Voronoi backends, polygon clipping,
+ * pattern instancing and a whole FractureJob per intact site count. Every stage is timed and its output count recorded, then written as JSON.
+ * With -llm, each stage also records the bytes its output holds under the GlassFracture LLM tag.
+ *
+ * UnrealEditor-Cmd <Project>.uproject -run=GlassFractureBenchmark -nullrhi -unattended [-llm]
+ *     [-Sites=10,100,1000,10000,100000] [-Rings=4,8,16] [-Spokes=8,16,32] [-JobSites=100,1000,10000] [-Iterations=5] [-Seed=1] [-Output=<file>]
+ */
+UCLASS()
+class GLASSFRACTUREEDITOR_API UGlassFractureBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UGlassFractureBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/* One measured stage; counts and bytes are per iteration */
+	struct StageSample
+	{
+		FString Stage;
+		int32 Sites = 0;
+		int32 Rings = 0;
+		int32 Spokes = 0;
+		FString Impact;
+		int32 Iterations = 0;
+		double MinMs = 0.0;
+		double MeanMs = 0.0;
+		int64 TrackedBytes = INDEX_NONE;	// Held under the GlassFracture LLM tag once the stage returns, INDEX_NONE without -llm
+		int32 Outputs = 0;
+	};
+
+private:
+	TArray<StageSample> Samples;
+	int32 Iterations = 5;
+	int32 Seed = 1;
+
+	void RunSiteSweep(int32 NumSites);
+	void RunPatternSweep(int32 Rings, int32 Spokes, const TArray<int32>& JobSiteCounts);
+
+	/* Runs Body Iterations times; Body returns the stage's output count and keeps the output alive until the next Release */
+	void Measure(StageSample Sample, TFunctionRef<void()> Release, TFunctionRef<int32()> Body);
+	static int64 GetTrackedBytes();
+
+	static UFracturePatternAsset* MakeSpiderwebPattern(int32 Rings, int32 Spokes, float Radius, int32 PatternSeed);
+	static TArray<int32> ParseCounts(const TMap<FString, FString>& ParamValues, const TCHAR* Key, const TCHAR* Default);
+	FString ToJson() const;
+};
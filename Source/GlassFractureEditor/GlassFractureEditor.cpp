@@ -0,0 +1,6 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Modules/ModuleManager.h"
+
+// Editor-only tooling for the GlassFracture module; kept out of cooked games
+IMPLEMENT_MODULE(FDefaultModuleImpl, GlassFractureEditor);